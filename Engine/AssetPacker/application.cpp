@@ -0,0 +1,335 @@
+#include <EngineCore/AssetManagement/asset_archive.h>
+#include <EngineCore/AssetManagement/compressed_asset.h>
+#include <EngineCore/AssetManagement/entity_file.h>
+#include <EngineCore/Pipeline/hash_id.h>
+#include <EngineCore/Runtime/task_scheduler.h>
+#include <EngineUtils/String/hex_strings.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// packs every loose asset referenced by the given entity files into one archive, run it in the folder that holds the
+// built .bse_entity and .bse_asset files:
+//     AssetPacker assets.bse_archive <entity file>...
+//
+// or compresses those loose assets in place and records their decompressed and compressed sizes in the entity files,
+// which are compressed as well (an archive packed afterwards keeps the assets compressed):
+//     AssetPacker --compress <entity file>...
+
+using namespace Engine::Core;
+
+static bool ReadAll(const char* path, std::vector<char>& output)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    output.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// the tool decompresses entity files on the calling thread
+class InlineScheduler : public Runtime::ITaskScheduler
+{
+public:
+    void ScheduleTask(Runtime::GenericTaskDelegate routine, void* state) override
+    {
+        routine(state);
+    }
+
+    Runtime::CallbackResult RunConcurrently(Runtime::ConcurrentTaskDelegate routine, void* state, size_t runnerCount) override
+    {
+        return routine(state, 0);
+    }
+
+    size_t GetConcurrency() const override
+    {
+        return 1;
+    }
+};
+
+// entity files compressed by an earlier --compress come back decompressed
+static bool ReadEntity(const char* path, std::vector<char>& output)
+{
+    std::vector<char> stored;
+    if (!ReadAll(path, stored))
+        return false;
+
+    AssetManagement::CompressedAssetHeader header;
+    if (!AssetManagement::ReadCompressedAssetHeader(stored.data(), stored.size(), &header))
+    {
+        output = std::move(stored);
+        return true;
+    }
+
+    InlineScheduler scheduler;
+    output.resize((size_t)header.UncompressedSize);
+    return AssetManagement::DecompressAsset(&scheduler, stored.data(), stored.size(), output.data(), output.size());
+}
+
+template <typename T>
+static bool ReadValue(const std::vector<char>& buffer, size_t& cursor, T& output)
+{
+    if (cursor + sizeof(T) > buffer.size())
+        return false;
+
+    std::copy(buffer.data() + cursor, buffer.data() + cursor + sizeof(T), (char*)&output);
+    cursor += sizeof(T);
+    return true;
+}
+
+// collects the asset section of an entity file, the rest of the file is of no interest here; sizeOffsets receives
+// where the recorded size of each collected asset is in the file, its compressed size follows right after
+static bool CollectAssets(const char* entityPath, std::vector<AssetManagement::AssetArchiveEntry>& entries, std::vector<size_t>* sizeOffsets = nullptr)
+{
+    std::vector<char> entity;
+    if (!ReadEntity(entityPath, entity))
+    {
+        std::cerr << "Error: can't read entity file " << entityPath << std::endl;
+        return false;
+    }
+
+    size_t cursor = 0;
+    unsigned int magicWord = 0;
+    int assetGroupCount = 0;
+    if (ReadValue(entity, cursor, magicWord) && magicWord == AssetManagement::LegacyEntityAssetSectionMagicWord)
+    {
+        std::cerr << "Error: " << entityPath << " was built without asset sizes, rebuild it with the current entity builder." << std::endl;
+        return false;
+    }
+    bool hasCompressedSizes = magicWord == AssetManagement::EntityAssetSectionMagicWord;
+    if ((!hasCompressedSizes && magicWord != AssetManagement::SizedEntityAssetSectionMagicWord) || !ReadValue(entity, cursor, assetGroupCount))
+    {
+        std::cerr << "Error: " << entityPath << " is not an entity file." << std::endl;
+        return false;
+    }
+    if (sizeOffsets != nullptr && !hasCompressedSizes)
+    {
+        std::cerr << "Error: " << entityPath << " has no room for compressed sizes, rebuild it with the current entity builder." << std::endl;
+        return false;
+    }
+
+    for (int group = 0; group < assetGroupCount; group++)
+    {
+        Pipeline::HashIdTuple assetGroupId;
+        int groupSize = 0;
+        if (!ReadValue(entity, cursor, assetGroupId) || !ReadValue(entity, cursor, groupSize))
+        {
+            std::cerr << "Error: asset section of " << entityPath << " is truncated." << std::endl;
+            return false;
+        }
+
+        for (int i = 0; i < groupSize; i++)
+        {
+            // the sizes recorded by the entity builder are ignored, the packed blob is measured directly
+            AssetManagement::AssetArchiveEntry entry {};
+            uint64_t assetSize = 0;
+            uint64_t compressedSize = 0;
+            if (!ReadValue(entity, cursor, entry.AssetId))
+            {
+                std::cerr << "Error: asset section of " << entityPath << " is truncated." << std::endl;
+                return false;
+            }
+
+            size_t sizeOffset = cursor;
+            if (!ReadValue(entity, cursor, assetSize) || (hasCompressedSizes && !ReadValue(entity, cursor, compressedSize)))
+            {
+                std::cerr << "Error: asset section of " << entityPath << " is truncated." << std::endl;
+                return false;
+            }
+
+            entry.AssetGroupId = assetGroupId;
+            entries.push_back(entry);
+            if (sizeOffsets != nullptr)
+                sizeOffsets->push_back(sizeOffset);
+        }
+    }
+
+    return true;
+}
+
+static bool WriteAll(const char* path, const void* data, size_t size)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char*)data, size);
+    return (bool)file;
+}
+
+struct AssetSizes
+{
+    uint64_t Size;
+    uint64_t CompressedSize;
+};
+
+static int CompressAssets(int entityCount, char** entityPaths)
+{
+    std::unordered_map<Pipeline::HashId, AssetSizes> visitedAssets;
+    size_t compressedCount = 0;
+    size_t rawBytes = 0;
+    size_t storedBytes = 0;
+
+    for (int i = 0; i < entityCount; i++)
+    {
+        std::vector<AssetManagement::AssetArchiveEntry> entries;
+        std::vector<size_t> sizeOffsets;
+        if (!CollectAssets(entityPaths[i], entries, &sizeOffsets))
+            return 1;
+
+        for (const AssetManagement::AssetArchiveEntry& entry : entries)
+        {
+            if (visitedAssets.count(entry.AssetId) > 0)
+                continue;
+
+            char nameBuffer[] = "2D87CCD68F05994578FAFA7AF7750AB4.bse_asset";
+            Engine::Utils::String::BinaryToHex(sizeof(entry.AssetId), entry.AssetId.Hash.data(), nameBuffer);
+
+            std::vector<char> blob;
+            if (!ReadAll(nameBuffer, blob))
+            {
+                std::cerr << "Error: can't read asset file " << nameBuffer << std::endl;
+                return 1;
+            }
+
+            // running the tool twice leaves compressed assets alone
+            AssetManagement::CompressedAssetHeader header;
+            if (AssetManagement::ReadCompressedAssetHeader(blob.data(), blob.size(), &header))
+            {
+                visitedAssets[entry.AssetId] = { header.UncompressedSize, blob.size() };
+                compressedCount++;
+                rawBytes += (size_t)header.UncompressedSize;
+                storedBytes += blob.size();
+                continue;
+            }
+
+            // assets that barely shrink stay raw, they'd only cost decompression time
+            std::vector<unsigned char> compressed;
+            AssetManagement::CompressAsset(blob.data(), blob.size(), AssetManagement::CompressedAssetBlockSize, compressed);
+            rawBytes += blob.size();
+            if (blob.empty() || compressed.size() > blob.size() / 8 * 7)
+            {
+                visitedAssets[entry.AssetId] = { blob.size(), 0 };
+                storedBytes += blob.size();
+                continue;
+            }
+
+            if (!WriteAll(nameBuffer, compressed.data(), compressed.size()))
+            {
+                std::cerr << "Error: failed writing " << nameBuffer << std::endl;
+                return 1;
+            }
+
+            visitedAssets[entry.AssetId] = { blob.size(), compressed.size() };
+            compressedCount++;
+            storedBytes += compressed.size();
+        }
+
+        // with both sizes in the entity file the engine reads compressed assets without looking them up first
+        std::vector<char> entity;
+        if (!ReadEntity(entityPaths[i], entity))
+            return 1;
+
+        for (size_t j = 0; j < entries.size(); j++)
+        {
+            const AssetSizes& sizes = visitedAssets[entries[j].AssetId];
+            std::copy((const char*)&sizes, (const char*)&sizes + sizeof(sizes), entity.begin() + sizeOffsets[j]);
+        }
+
+        // the entity file itself only stays raw when it barely shrinks, like the assets
+        std::vector<unsigned char> compressedEntity;
+        AssetManagement::CompressAsset(entity.data(), entity.size(), AssetManagement::CompressedAssetBlockSize, compressedEntity);
+        bool entityWritten = compressedEntity.size() <= entity.size() / 8 * 7
+            ? WriteAll(entityPaths[i], compressedEntity.data(), compressedEntity.size())
+            : WriteAll(entityPaths[i], entity.data(), entity.size());
+        if (!entityWritten)
+        {
+            std::cerr << "Error: failed writing " << entityPaths[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Compressed " << compressedCount << " of " << visitedAssets.size() << " asset(s), " << rawBytes << " -> " << storedBytes << " bytes." << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: AssetPacker <output archive> <entity file>..." << std::endl;
+        std::cerr << "       AssetPacker --compress <entity file>..." << std::endl;
+        return 1;
+    }
+
+    if (std::string(argv[1]) == "--compress")
+        return CompressAssets(argc - 2, argv + 2);
+
+    std::vector<AssetManagement::AssetArchiveEntry> entries;
+    for (int i = 2; i < argc; i++)
+    {
+        if (!CollectAssets(argv[i], entries))
+            return 1;
+    }
+
+    // the runtime binary searches the table, assets shared between entities are packed once
+    std::sort(entries.begin(), entries.end(), [](const AssetManagement::AssetArchiveEntry& a, const AssetManagement::AssetArchiveEntry& b)
+    {
+        return a.AssetId < b.AssetId;
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const AssetManagement::AssetArchiveEntry& a, const AssetManagement::AssetArchiveEntry& b)
+    {
+        return a.AssetId == b.AssetId;
+    }), entries.end());
+
+    // load every blob and lay them out behind the table
+    std::vector<std::vector<char>> blobs(entries.size());
+    uint64_t offset = sizeof(AssetManagement::AssetArchiveHeader) + entries.size() * sizeof(AssetManagement::AssetArchiveEntry);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        char nameBuffer[] = "2D87CCD68F05994578FAFA7AF7750AB4.bse_asset";
+        Engine::Utils::String::BinaryToHex(sizeof(entries[i].AssetId), entries[i].AssetId.Hash.data(), nameBuffer);
+
+        if (!ReadAll(nameBuffer, blobs[i]))
+        {
+            std::cerr << "Error: can't read asset file " << nameBuffer << std::endl;
+            return 1;
+        }
+
+        offset = (offset + AssetManagement::AssetArchiveAlignment - 1) / AssetManagement::AssetArchiveAlignment * AssetManagement::AssetArchiveAlignment;
+        entries[i].Offset = offset;
+        entries[i].Size = blobs[i].size();
+        offset += blobs[i].size();
+    }
+
+    std::ofstream output(argv[1], std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        std::cerr << "Error: can't open " << argv[1] << " for writing." << std::endl;
+        return 1;
+    }
+
+    AssetManagement::AssetArchiveHeader header { AssetManagement::AssetArchiveMagicWord, AssetManagement::AssetArchiveVersion, entries.size() };
+    output.write((const char*)&header, sizeof(header));
+    output.write((const char*)entries.data(), entries.size() * sizeof(AssetManagement::AssetArchiveEntry));
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        // pad up to the blob's aligned offset
+        static const char Padding[AssetManagement::AssetArchiveAlignment] {};
+        output.write(Padding, entries[i].Offset - (uint64_t)output.tellp());
+        output.write(blobs[i].data(), blobs[i].size());
+    }
+
+    if (!output)
+    {
+        std::cerr << "Error: failed writing " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << entries.size() << " asset(s) into " << argv[1] << " (" << offset << " bytes)." << std::endl;
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "EngineCore/Pipeline/hash_id.h"
+#include "EngineUtils/Memory/mapped_file.h"
+
+#include <cstdint>
+
+namespace Engine::Core::AssetManagement {
+
+// archive layout: header, entry table sorted by asset id, then one blob per entry starting at an AssetArchiveAlignment
+// boundary; offsets are relative to the start of the file
+constexpr uint32_t AssetArchiveMagicWord = 0xCCBBFFA1;
+constexpr uint32_t AssetArchiveVersion = 1;
+constexpr size_t AssetArchiveAlignment = 64;
+
+struct AssetArchiveHeader
+{
+    uint32_t MagicWord;
+    uint32_t Version;
+    uint64_t EntryCount;
+};
+
+struct AssetArchiveEntry
+{
+    Pipeline::HashId AssetId;
+    Pipeline::HashIdTuple AssetGroupId;
+    uint64_t Offset;
+    uint64_t Size;
+};
+
+// a packed archive mapped into memory once; blobs are handed to the asset pipeline in place
+class AssetArchive
+{
+private:
+    Utils::Memory::MappedFile m_File;
+    const AssetArchiveEntry* m_Entries = nullptr;
+    size_t m_EntryCount = 0;
+
+public:
+    // false if the file is missing or malformed, the archive stays empty in that case
+    bool Open(const char* path);
+
+    // binary search on the entry table, null if the asset isn't packed
+    const AssetArchiveEntry* Find(const Pipeline::HashId& assetId) const;
+
+    inline void* GetData(const AssetArchiveEntry* entry) const
+    {
+        return static_cast<char*>(m_File.GetData()) + entry->Offset;
+    }
+
+    inline bool IsOpen() const { return m_File.IsOpen(); }
+    inline size_t GetEntryCount() const { return m_EntryCount; }
+};
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "EngineCore/Configuration/configuration_provider.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace Engine::Core::AssetManagement {
+
+enum class AssetIoStatus
+{
+    Complete,
+    Failure,
+    Canceled
+};
+
+struct AssetIoCompletion
+{
+    void* UserData;
+    AssetIoStatus Status;
+
+    // only valid until the next call into the backend
+    const char* ErrorDetail;
+};
+
+// everything the asset manager reads from disk goes through here; requests are whole operations (open, read, close) so
+// a backend is free to batch and chain them, and completions are polled from the main thread
+class IAssetIoBackend
+{
+public:
+    virtual ~IAssetIoBackend() = default;
+
+    virtual const char* GetName() const = 0;
+
+    // reads size bytes at offset of the file into destination, userData comes back with the completion; the request
+    // may be held back until the next Submit, false if it can't be made at all
+    virtual bool QueueRead(const char* path, void* destination, size_t offset, size_t size, void* userData) = 0;
+
+    // hands every request queued so far to the OS
+    virtual void Submit() = 0;
+
+    // takes one finished request without blocking, false if none is ready
+    virtual bool GetCompletion(AssetIoCompletion* outCompletion) = 0;
+
+    // reads into a registered range can skip per-request setup (page pinning for io_uring); the range must stay allocated
+    // until it's unregistered, which takes effect once the reads queued into it finished; backends may ignore both
+    virtual void RegisterBuffer(void* base, size_t size) {}
+    virtual void UnregisterBuffer(void* base) {}
+};
+
+// io_uring if it's enabled and the kernel supports everything the backend needs, SDL async IO otherwise
+std::unique_ptr<IAssetIoBackend> CreateAssetIoBackend(const Configuration::ConfigurationProvider* configs);
+
+}
@@ -3,12 +3,15 @@
 #include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Runtime/transient_allocator.h"
 
+#include <cstddef>
+
 namespace Engine::Core::AssetManagement {
 
 enum class LoadBufferType
 {
     TransientBuffer,
     ModuleBuffer,
+    MappedBuffer, // points straight into a mapped asset archive, valid for the lifetime of the asset manager
     Invalid
 };
 
@@ -18,10 +21,26 @@ struct LoadBuffer
         int TransientBufferSize;
         Runtime::TransientBufferId TransientBufferId;
         void* ModuleBuffer; // this buffer is fully allocated before the contextualizer exits
+        void* MappedBuffer;
     } Location;
     LoadBufferType Type;
 };
 
+// load requests are contextualized, and their reads started, most urgent first; requests of the same priority are
+// served in the order they were made
+enum class LoadPriority : unsigned char
+{
+    Critical,
+    Visible,
+    Prefetch,
+    Background
+};
+
+constexpr size_t LoadPriorityCount = 4;
+
+// at most this many assets can be declared as dependencies of one asset
+constexpr size_t MaxAssetDependencies = 8;
+
 struct AssetLoadingContext
 {
     bool ReplaceExisting;
@@ -30,6 +49,46 @@ struct AssetLoadingContext
     Pipeline::HashId AssetId;
     LoadBuffer Buffer;
     void* UserData;
+
+    // set when the asset is packed in a mapped archive, contextualizers of read-only assets can use it as a
+    // MappedBuffer instead of asking for a copy
+    void* MappedSource;
+
+    // set when the asset is stored compressed, SourceSize is the size after decompression then; packed blobs are
+    // decompressed straight out of the archive, MappedSource stays null for them
+    size_t CompressedSize;
+    const void* CompressedSource;
+
+    // assets that must be indexed before this one, declared by contextualize or process; the asset manager holds the
+    // context back while any of them is still on its way, dependencies that aren't loading at all don't block it
+    Pipeline::HashId Dependencies[MaxAssetDependencies];
+    size_t DependencyCount;
+
+    LoadPriority Priority;
 };
 
+inline bool AddDependency(AssetLoadingContext* context, Pipeline::HashId dependency)
+{
+    if (context->DependencyCount >= MaxAssetDependencies)
+        return false;
+
+    context->Dependencies[context->DependencyCount] = dependency;
+    context->DependencyCount++;
+    return true;
+}
+
+// the loaded bytes of a module or mapped buffer, transient buffers have to go through the transient allocator
+inline void* GetModuleVisibleBuffer(const AssetLoadingContext* context)
+{
+    switch (context->Buffer.Type)
+    {
+    case LoadBufferType::ModuleBuffer:
+        return context->Buffer.Location.ModuleBuffer;
+    case LoadBufferType::MappedBuffer:
+        return context->Buffer.Location.MappedBuffer;
+    default:
+        return nullptr;
+    }
+}
+
 }
\ No newline at end of file
@@ -3,8 +3,13 @@
 #include "EngineCore/AssetManagement/asset_loading_context.h"
 #include "EngineCore/Pipeline/asset_definition.h"
 #include "EngineCore/Pipeline/hash_id.h"
+#include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/transient_allocator.h"
 
+#include <atomic>
+#include <cstdlib>
+#include <utility>
+
 namespace Engine::Core::AssetManagement {
 
 enum class EventType
@@ -22,24 +27,45 @@ public:
 class AsyncAssetEvent : public AsyncIoEvent
 {
 private:
-    bool m_Available;
+    // set last by a worker running the process stage, everything else in the event is visible once this is
+    std::atomic<bool> m_Available;
     bool m_Broken;
     const Pipeline::AssetDefinition* m_Definition;
     void* m_ModuleState;
     AssetManagement::AssetLoadingContext m_LoadingContext;
 
+    // process stage
+    void* m_LoadedData;
+    const Runtime::ServiceTable* m_Services;
+    Runtime::CallbackResult m_ProcessResult;
+
+    // compressed bytes to decompress into the loaded data, owned by the event if they were read into a staging buffer
+    const void* m_CompressedData;
+    void* m_CompressedStaging;
+
 public:
     AsyncAssetEvent(const AssetManagement::AssetLoadingContext& source, const Pipeline::AssetDefinition* definition, void* module)
-        : m_Available(false), m_Broken(false), m_Definition(definition), m_ModuleState(module), m_LoadingContext(source)
+        : m_Available(false), m_Broken(false), m_Definition(definition), m_ModuleState(module), m_LoadingContext(source), m_LoadedData(nullptr), m_Services(nullptr), m_CompressedData(nullptr), m_CompressedStaging(nullptr)
     {}
 
-    bool IsAvailable() const { return m_Available; }
+    bool IsAvailable() const { return m_Available.load(std::memory_order_acquire); }
     bool IsBroken() const { return m_Broken; }
     AssetManagement::AssetLoadingContext* GetContext() { return &m_LoadingContext; }
 
-    void MakeAvailable() { m_Available = true; }
+    void MakeAvailable() { m_Available.store(true, std::memory_order_release); }
     void MakeBroken() { m_Broken = true; }
 
+    void PrepareProcess(void* loadedData, const Runtime::ServiceTable* services) { m_LoadedData = loadedData; m_Services = services; }
+    void* GetLoadedData() const { return m_LoadedData; }
+    const Runtime::ServiceTable* GetServices() const { return m_Services; }
+    const Runtime::CallbackResult& GetProcessResult() const { return m_ProcessResult; }
+    void SetProcessResult(Runtime::CallbackResult result) { m_ProcessResult = std::move(result); }
+
+    void SetCompressedData(const void* data) { m_CompressedData = data; }
+    void* AllocateCompressedStaging(size_t size) { m_CompressedStaging = std::malloc(size); m_CompressedData = m_CompressedStaging; return m_CompressedStaging; }
+    void ReleaseCompressedData() { std::free(m_CompressedStaging); m_CompressedStaging = nullptr; m_CompressedData = nullptr; }
+    const void* GetCompressedData() const { return m_CompressedData; }
+
     EventType GetType() const override { return EventType::Asset; }
     const Pipeline::AssetDefinition* GetDefinition() const { return m_Definition; }
     void* GetModuleState() { return m_ModuleState; }
@@ -51,14 +77,24 @@ private:
     Runtime::TransientBufferId m_Buffer;
     size_t m_Length;
     Pipeline::HashId m_Id;
+    LoadPriority m_Priority;
+
+    // the read can't be taken back from the OS, a canceled entity is dropped once it completes
+    bool m_Canceled;
 
 public:
-    AsyncEntityEvent(Runtime::TransientBufferId bufferId, size_t length, Pipeline::HashId id)
+    AsyncEntityEvent(Runtime::TransientBufferId bufferId, size_t length, Pipeline::HashId id, LoadPriority priority)
         : m_Buffer(bufferId),
         m_Length(length),
-        m_Id(id)
+        m_Id(id),
+        m_Priority(priority),
+        m_Canceled(false)
     {}
 
+    LoadPriority GetPriority() const { return m_Priority; }
+    bool IsCanceled() const { return m_Canceled; }
+    void Cancel() { m_Canceled = true; }
+
     EventType GetType() const override { return EventType::Entity; }
 
     Runtime::TransientBufferId GetBuffer() const { return m_Buffer; }
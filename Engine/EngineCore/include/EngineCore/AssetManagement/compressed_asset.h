@@ -0,0 +1,40 @@
+#pragma once
+
+#include "EngineCore/Runtime/task_scheduler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine::Core::AssetManagement {
+
+// compressed asset layout: header, block table, then the blocks; every block but the last one decompresses to
+// BlockSize bytes, blocks whose stored size equals their decompressed size are stored raw because they didn't shrink
+constexpr uint32_t CompressedAssetMagicWord = 0xCCBBFFC1;
+constexpr size_t CompressedAssetBlockSize = 256 * 1024;
+
+struct CompressedAssetHeader
+{
+    uint32_t MagicWord;
+    uint32_t BlockSize;
+    uint64_t UncompressedSize;
+    uint64_t BlockCount;
+};
+
+struct CompressedAssetBlock
+{
+    uint64_t Offset; // relative to the start of the header
+    uint64_t Size;
+};
+
+// true if the data starts with a header whose block table fits into size bytes, the blocks themselves aren't checked
+bool ReadCompressedAssetHeader(const void* data, size_t size, CompressedAssetHeader* outHeader);
+
+// decompresses every block into destination, several blocks at once on the given scheduler; false if the data is
+// malformed or doesn't decompress to exactly destinationSize bytes
+bool DecompressAsset(Runtime::ITaskScheduler* scheduler, const void* data, size_t size, void* destination, size_t destinationSize);
+
+// writes a whole compressed asset, used by tools
+void CompressAsset(const void* source, size_t size, size_t blockSize, std::vector<unsigned char>& output);
+
+}
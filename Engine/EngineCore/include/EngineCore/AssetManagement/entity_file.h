@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Engine::Core::AssetManagement {
+
+// entity files are written by the entity builder (Tools/BuildSystem), the words have to match BuildEntityCommand
+
+// every asset in the asset section is followed by its size and the size of its compressed file (both 0 when unknown,
+// the compressed size also when the file is stored raw)
+constexpr uint32_t EntityAssetSectionMagicWord = 0xCCBBFFF5;
+
+// the asset section before compressed sizes, still read; compressed assets are listed with size 0 in it
+constexpr uint32_t SizedEntityAssetSectionMagicWord = 0xCCBBFFF4;
+
+// the first asset section format didn't have sizes at all, its magic word is still recognized to tell the entity needs
+// a rebuild instead of misreading ids as sizes
+constexpr uint32_t LegacyEntityAssetSectionMagicWord = 0xCCBBFFF1;
+
+constexpr uint32_t EntitySectionMagicWord = 0xCCBBFFF2;
+constexpr uint32_t EntityComponentSectionMagicWord = 0xCCBBFFF3;
+
+}
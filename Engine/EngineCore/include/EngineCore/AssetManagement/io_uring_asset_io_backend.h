@@ -0,0 +1,109 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "EngineCore/AssetManagement/asset_io_backend.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace Engine::Core::AssetManagement {
+
+// every read is an open, read and close chained as linked submissions on a direct (ring-owned) descriptor, so a whole
+// batch of files costs a single syscall to submit and none to open or close; reads into registered buffers use the
+// fixed buffer variant that skips pinning the destination pages per request
+class IoUringAssetIoBackend : public IAssetIoBackend
+{
+private:
+    static constexpr size_t MaxRegisteredBuffers = 64;
+
+    // a request owns the direct descriptor slot of the same index while its three submissions are on their way
+    struct Request
+    {
+        std::string Path;
+        void* UserData = nullptr;
+        size_t Size = 0;
+        int OpenResult = 0;
+        int ReadResult = 0;
+        int BufferSlot = -1;
+        int PendingCompletions = 0;
+    };
+
+    struct PendingRead
+    {
+        std::string Path;
+        void* Destination;
+        size_t Offset;
+        size_t Size;
+        void* UserData;
+        int BufferSlot;
+    };
+
+    struct RegisteredBuffer
+    {
+        unsigned char* Base = nullptr;
+        size_t Size = 0;
+        size_t PendingReads = 0;
+        bool Retired = false;
+    };
+
+    int m_RingFd;
+
+    // rings shared with the kernel
+    void* m_SqRing;
+    size_t m_SqRingSize;
+    void* m_CqRing;
+    size_t m_CqRingSize;
+    io_uring_sqe* m_Sqes;
+    size_t m_SqesSize;
+    unsigned* m_SqHead;
+    unsigned* m_SqTail;
+    unsigned* m_SqArray;
+    unsigned m_SqMask;
+    unsigned m_SqEntries;
+    unsigned* m_CqHead;
+    unsigned* m_CqTail;
+    unsigned m_CqMask;
+    io_uring_cqe* m_Cqes;
+
+    // submissions written to the ring but not handed to the kernel yet
+    unsigned m_SqLocalTail;
+    unsigned m_Unsubmitted;
+
+    std::vector<Request> m_Requests;
+    std::vector<int> m_FreeRequests;
+    size_t m_RequestsInFlight;
+    std::deque<PendingRead> m_Backlog;
+    std::deque<AssetIoCompletion> m_Ready;
+    std::vector<RegisteredBuffer> m_Buffers;
+
+    io_uring_sqe* NextSqe();
+    void StartRequest(PendingRead& read);
+    void Reap();
+    void FinishRequest(int slot);
+    bool UpdateBufferSlot(int slot, void* base, size_t size);
+
+public:
+    IoUringAssetIoBackend();
+    ~IoUringAssetIoBackend() override;
+
+    // false if the kernel lacks io_uring or direct descriptors, the backend can't be used then
+    bool Initialize(unsigned int queueDepth);
+
+    const char* GetName() const override { return "io_uring"; }
+
+    bool QueueRead(const char* path, void* destination, size_t offset, size_t size, void* userData) override;
+    void Submit() override;
+    bool GetCompletion(AssetIoCompletion* outCompletion) override;
+
+    void RegisterBuffer(void* base, size_t size) override;
+    void UnregisterBuffer(void* base) override;
+};
+
+}
+
+#endif
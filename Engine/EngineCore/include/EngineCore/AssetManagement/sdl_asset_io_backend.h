@@ -0,0 +1,25 @@
+#pragma once
+
+#include "EngineCore/AssetManagement/asset_io_backend.h"
+#include "SDL3/SDL_asyncio.h"
+
+namespace Engine::Core::AssetManagement {
+
+// portable fallback, SDL runs every request as its own open, read and close (on Linux on a pool of threads)
+class SdlAssetIoBackend : public IAssetIoBackend
+{
+private:
+    SDL_AsyncIOQueue* m_Queue;
+
+public:
+    SdlAssetIoBackend();
+    ~SdlAssetIoBackend() override;
+
+    const char* GetName() const override { return "SDL async IO"; }
+
+    bool QueueRead(const char* path, void* destination, size_t offset, size_t size, void* userData) override;
+    void Submit() override {}
+    bool GetCompletion(AssetIoCompletion* outCompletion) override;
+};
+
+}
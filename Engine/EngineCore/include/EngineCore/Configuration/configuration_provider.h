@@ -13,6 +13,11 @@ struct ConfigurationProvider
 
     long long STRING_LOAD_BUFFER_SIZE = 128;
     bool UseDeviceValidation = true;
+
+    // no window and no GPU device, the graphics layer only counts the commands it is asked to record; FrameLimit stops
+    // the game loop after that many frames (0 runs until quit), mostly useful for benchmarks
+    bool Headless = false;
+    size_t FrameLimit = 0;
     size_t INITIAL_STACK_SIZE = 512 * 1024 * 1024;
 
     int EntityVersion = 1;
@@ -21,8 +26,48 @@ struct ConfigurationProvider
     Logging::LogLevel MinimumLogLevel = Logging::LogLevel::Information;
 
     size_t WorkerCount = 2;
+
+    // time the asset manager may spend per frame on IO completions, contextualization and indexing; leftover work
+    // carries over to the next frame, 0 disables the limit
+    long long AssetPollBudgetMicroseconds = 2000;
+
+    // asset reads handed to the OS at once, the rest wait in priority order so urgent requests can overtake a large
+    // batch of less urgent ones; 0 disables the limit
+    size_t MaxAssetReadsInFlight = 64;
+
+    // read asset files through io_uring where the kernel supports it (SDL async IO otherwise); the queue depth bounds
+    // the reads submitted at once, each read takes three entries (open, read, close)
+    bool UseIoUring = true;
+    unsigned int IoUringQueueDepth = 256;
+
+    // bytes of loaded assets kept around once no loaded entity references them, they are unloaded least recently
+    // released first when the total goes beyond this; 0 unloads them as soon as the last reference is gone
+    size_t AssetMemoryBudget = 256 * 1024 * 1024;
+
+    // bytes each subsystem may hold before the memory tracker warns about it, checked at the end of every frame; 0
+    // disables the check
+    size_t TransientMemoryBudget = 512 * 1024 * 1024;
+    size_t HeapMemoryBudget = 256 * 1024 * 1024;
+    size_t ContainerMemoryBudget = 64 * 1024 * 1024;
+    size_t GpuMemoryBudget = (size_t)1024 * 1024 * 1024;
+    size_t ScriptingMemoryBudget = 64 * 1024 * 1024;
+
+    // opt-in: simulation advances in fixed steps of FixedTimeStep milliseconds, rendering interpolates between the last
+    // two steps; at most MaxSimulationSteps are run per rendered frame, time beyond that is dropped. off by default, every
+    // rendered frame then runs one step as long as the frame
+    bool UseFixedTimeStep = false;
+    float FixedTimeStep = 1000.0f / 60.0f;
+    int MaxSimulationSteps = 5;
+
+    // simulate the next frame on a worker while the main thread records the current one; rendering then reads a copy of
+    // the root module's transforms and cameras taken at the frame boundary, so the picture lags one frame behind
+    bool PipelinedSimulation = false;
 };
 
 constexpr size_t EntityLoadBatchSize = 1024;
+constexpr size_t EventPageSize = 64 * 1024;
+
+// packed assets are looked up here first, anything not in the archive is loaded as a loose file
+constexpr const char* AssetArchiveName = "assets.bse_archive";
 
 } // namespace Engine::Core::Configuration
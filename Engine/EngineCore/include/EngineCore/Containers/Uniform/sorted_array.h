@@ -47,36 +47,54 @@ private:
     size_t m_Size;
     size_t m_Capacity;
 
+    // a failed allocation leaves the array as it was
+    bool Grow(size_t capacity)
+    {
+        void* storage = m_Storage != nullptr
+            ? m_Allocator->Reallocate((void*)m_Storage, capacity * sizeof(T))
+            : m_Allocator->Allocate(capacity * sizeof(T));
+        if (storage == nullptr)
+            return false;
+
+        m_Storage = static_cast<T*>(storage);
+        m_Capacity = capacity;
+        return true;
+    }
+
 public:
     SortedArray(IContainerAllocationStrategy* allocator, size_t initialCapacity)
-        : m_Allocator(allocator), m_Storage(nullptr), m_Size(0), m_Capacity(initialCapacity)
+        : m_Allocator(allocator), m_Storage(nullptr), m_Size(0), m_Capacity(0)
     {
         if (initialCapacity > 0)
         {
-            m_Storage = static_cast<T*>(allocator->Allocate(initialCapacity * sizeof(T)));
+            Grow(initialCapacity);
         }
     }
 
     void Destroy()
     {
-        m_Allocator->Free(m_Storage);
+        if (m_Storage != nullptr)
+            m_Allocator->Free(m_Storage);
         m_Storage = nullptr;
+        m_Size = 0;
+        m_Capacity = 0;
     }
 
-    void ReserveExtra(size_t count) 
+    // grows the capacity at least twofold, so inserting one element at a time reallocates O(log n) times; false if
+    // the allocator is out of memory
+    bool ReserveExtra(size_t count) 
     {
         if (m_Size + count <= m_Capacity)
-            return;
-        m_Storage = (T*)m_Allocator->Reallocate((void*)m_Storage, (m_Size + count) * sizeof(T));
-        m_Capacity = m_Size + count;
+            return true;
+        return Grow(m_Size + count > m_Capacity * 2 ? m_Size + count : m_Capacity * 2);
     }
 
-    void ReserveTotal(size_t count) 
+    // exactly what's asked for
+    bool ReserveTotal(size_t count) 
     {
         if (count <= m_Capacity)
-            return;
-        m_Storage = (T*)m_Allocator->Reallocate((void*)m_Storage, count * sizeof(T));
-        m_Capacity = count;
+            return true;
+        return Grow(count);
     }
 
     size_t GetCount() const
@@ -97,7 +115,8 @@ public:
     // Insert a singular element, if the key is not unqiue a duplicate is inserted.
     void Insert(const T& element)
     {
-        ReserveExtra(1);
+        if (!ReserveExtra(1))
+            return;
 
         if (m_Size == 0)
         {
@@ -123,7 +142,8 @@ public:
     // Insert a singular element, if the key is not unique the insertion is dropped.
     bool TryInsert(const T& element)
     {
-        ReserveExtra(1);
+        if (!ReserveExtra(1))
+            return false;
 
         if (m_Size == 0)
         {
@@ -155,7 +175,8 @@ public:
     // Insert a singular element, if the key is not unique the original copy is overwritten
     void Replace(const T& element)
     {
-        ReserveExtra(1);
+        if (!ReserveExtra(1))
+            return;
 
         if (m_Size == 0)
         {
@@ -232,7 +253,8 @@ public:
     // Allocate and asign all elements at once, then do a full buffer sort.
     void InsertRange(const T* elements, size_t count) 
     {
-        ReserveExtra(count);
+        if (!ReserveExtra(count))
+            return;
 
         for (size_t i = 0; i < count; i++)
         {
@@ -250,7 +272,8 @@ public:
     template <typename TUserData>
     void InsertRange(size_t count, TUserData* userdata, void(*writer)(T*, size_t, TUserData*))
     {
-        ReserveExtra(count);
+        if (!ReserveExtra(count))
+            return;
 
         writer(&m_Storage[m_Size], count, userdata);
 
@@ -258,6 +281,30 @@ public:
         SDL_qsort(m_Storage, m_Size, sizeof(T), CompareCore);
     }
 
+    // Remove the element at the given position, everything behind it moves one slot to the left.
+    void RemoveAt(size_t index)
+    {
+        if (index >= m_Size)
+            return;
+
+        for (size_t movee = index + 1; movee < m_Size; movee ++)
+        {
+            m_Storage[movee - 1] = m_Storage[movee];
+        }
+        m_Size--;
+    }
+
+    // Remove the element matching the key exactly, returns false if there is none.
+    bool Remove(const T& key)
+    {
+        size_t position = Search(key);
+        if (position >= m_Size)
+            return false;
+
+        RemoveAt(position);
+        return true;
+    }
+
     T* PtrAt(size_t index)
     {
         if (index >= m_Size)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EngineCore/AssetManagement/asset_loading_context.h"
+#include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Pipeline/name_pair.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/fwd.h"
@@ -16,6 +17,15 @@ struct AssetDefinition
     // new asset system
     Runtime::CallbackResult (*Contextualize)(Runtime::ServiceTable *services, void *moduleState, AssetManagement::AssetLoadingContext* outContext, size_t contextCount);
     Runtime::CallbackResult (*Index)(Runtime::ServiceTable *services, void *moduleState, AssetManagement::AssetLoadingContext* inContext);
+
+    // optional, runs on a task manager worker between load and index with the loaded bytes; it may transform them in
+    // place or leave its output in the context's UserData, but must not modify module state since the main thread keeps
+    // running; index then only has to publish the result
+    Runtime::CallbackResult (*Process)(const Runtime::ServiceTable *services, const void *moduleState, AssetManagement::AssetLoadingContext* inContext, void* loadedData);
+
+    // optional, releases everything the module keeps for an asset once no loaded entity references it anymore and the
+    // memory budget needs the space; asset types without it stay resident until the module is disposed
+    Runtime::CallbackResult (*Unload)(Runtime::ServiceTable *services, void *moduleState, HashId assetId);
 };
 
 }
\ No newline at end of file
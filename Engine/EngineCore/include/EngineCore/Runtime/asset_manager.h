@@ -1,7 +1,10 @@
 #pragma once
 
+#include "EngineCore/AssetManagement/asset_archive.h"
+#include "EngineCore/AssetManagement/asset_io_backend.h"
 #include "EngineCore/AssetManagement/asset_loading_context.h"
 #include "EngineCore/AssetManagement/async_io_event.h"
+#include "EngineCore/Configuration/configuration_provider.h"
 #include "EngineCore/Logging/logger.h"
 #include "EngineCore/Logging/logger_service.h"
 #include "EngineCore/Pipeline/asset_definition.h"
@@ -9,12 +12,14 @@
 #include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Pipeline/module_assembly.h"
 #include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/task_manager.h"
 #include "EngineCore/Runtime/transient_allocator.h"
 #include "EngineUtils/Memory/memstream_lite.h"
-#include "SDL3/SDL_asyncio.h"
 #include "EngineCore/Runtime/index_queue.h"
 #include "SDL3/SDL_storage.h"
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -34,27 +39,107 @@ private:
     // used for utilities
     SDL_Storage* m_StorageFolder;
 
+    // mapped once at start up, entity loads prefer it over loose files
+    AssetManagement::AssetArchive m_Archive;
+
     // generate them somehow
     std::unordered_map<Pipeline::HashIdTuple, Pipeline::ComponentDefinition> m_Components;
     std::unordered_map<Pipeline::HashIdTuple, Pipeline::AssetDefinition> m_AssetDefinitions;
 
     // services
+    const Configuration::ConfigurationProvider* m_Configs;
     Logging::Logger m_Logger;
     ServiceTable* m_Services;
 
-    // contextualization
-    std::vector<AssetManagement::AssetLoadingContext> m_AssetReloadQueue;
-    std::vector<AssetManagement::AssetLoadingContext> m_ContextualizeQueue;
-
-    // indexing
-    IndexQueue* m_DependencyAgnosticIndexQueue;
-    std::unordered_map<Pipeline::HashId, IndexQueue*> m_IndexQueues;
-
-    std::vector<Pipeline::HashId> m_EntityScheduleQueue;
-    std::vector<AssetManagement::AsyncEntityEvent> m_EntityLoadingQueue;
+    // contextualization, one queue per priority; reloads and entity assets share them
+    std::vector<AssetManagement::AssetLoadingContext> m_ContextualizeQueues[AssetManagement::LoadPriorityCount];
+    size_t m_ReadsInFlight;
+    bool HasQueuedContexts() const;
+
+    // indexing: events wait in the order they were contextualized, but any of them is indexed as soon as it's loaded and
+    // none of its dependencies is still on its way, so independent assets don't queue up behind slow ones
+    struct IndexWaiter
+    {
+        AssetManagement::AsyncAssetEvent* Event;
+        IndexQueue* Queue;
+    };
+    std::vector<IndexQueue*> m_IndexQueues;
+    std::vector<IndexWaiter> m_IndexWaitList;
+
+    // an asset is identified by its group and id together, two modules may well use the same id for different things
+    struct AssetKey
+    {
+        Pipeline::HashIdTuple AssetGroupId;
+        Pipeline::HashId AssetId;
+
+        inline bool operator==(const AssetKey& other) const
+        {
+            return AssetGroupId == other.AssetGroupId && AssetId == other.AssetId;
+        }
+    };
+    struct AssetKeyHash
+    {
+        std::size_t operator()(const AssetKey& k) const
+        {
+            return std::hash<Pipeline::HashIdTuple>()(k.AssetGroupId) ^ std::hash<Pipeline::HashId>()(k.AssetId);
+        }
+    };
+
+    // assets queued for loading but not indexed yet, by the number of contexts on their way; dependencies only name the
+    // asset id so they are counted by that
+    std::unordered_map<Pipeline::HashId, size_t> m_PendingAssets;
+    void TrackPendingAsset(const AssetKey& key);
+    void UntrackPendingAsset(const AssetKey& key);
+    void UntrackPendingAsset(const AssetManagement::AssetLoadingContext& context);
+    bool HasPendingDependencies(const AssetManagement::AssetLoadingContext* context) const;
+
+    IndexQueue* CreateIndexQueue(size_t eventCount);
+    CallbackResult IndexReadyAssets(Uint64 deadline);
+
+    // assets of one entity whose size wasn't in the entity file; a worker looks all of them up in one go and the whole
+    // batch joins the contextualization queue afterwards, so asset groups keep their order
+    struct AssetSizeBatch
+    {
+        std::vector<AssetManagement::AssetLoadingContext> Contexts;
+        SDL_Storage* Storage;
+        std::atomic<bool> Completed { false };
+    };
+    std::vector<std::unique_ptr<AssetSizeBatch>> m_AssetSizeBatches;
+    TaskCounter m_SizeTasks;
+    static CallbackResult ResolveAssetSizes(void* state);
+    void DrainAssetSizeBatches();
+
+    // residency: every asset listed in a loaded entity file is referenced by it, assets nothing references anymore stay
+    // loaded as a cache until the memory budget forces them out, least recently released first; the same table is the
+    // one place duplicates are caught, an asset that is resident or on its way is never loaded a second time
+    struct AssetRecord
+    {
+        size_t ReferenceCount = 0;
+        size_t Footprint = 0;
+        size_t LoadsInFlight = 0;
+        Uint64 ReleasedAt = 0;
+        bool Resident = false;
+    };
+    std::unordered_map<AssetKey, AssetRecord, AssetKeyHash> m_AssetRecords;
+    std::unordered_map<Pipeline::HashId, std::vector<AssetKey>> m_EntityAssetReferences;
+    size_t m_ResidentAssetBytes;
+    Uint64 m_ReleaseClock;
+    bool m_BudgetCheckPending;
+
+    AssetRecord& AcquireAsset(const AssetKey& key);
+    void ReleaseAsset(const AssetKey& key);
+    bool IsAssetReferenced(const AssetManagement::AssetLoadingContext& context) const;
+    void ReleaseEntityAssets(Pipeline::HashId entityId);
+    void OnAssetIndexed(const AssetManagement::AssetLoadingContext* context);
+    CallbackResult EnforceMemoryBudget();
+
+    // entity files being read, their events are handed to SDL and have to stay put until the read completes
+    std::vector<std::unique_ptr<AssetManagement::AsyncEntityEvent>> m_EntityLoadingQueue;
+
+    // drops queued contexts of assets no loaded entity references anymore, reads already started run to completion
+    void DropUnreferencedContexts();
 
     // asynchronous event handling
-    CallbackResult ProcessIndexQueue(IndexQueue*& queue);
     CallbackResult PollEvents();
     
     void OnEntityReady(TransientBufferId buffer, Pipeline::HashId id);
@@ -63,22 +148,38 @@ private:
                                int componentCount);
     void OnAssetReady(AssetManagement::AssetLoadingContext context);
 
-    // actually asynchronous: use the asyncIO API to load data (this implementation assumes loose data; contain all IO code in here so we can swap out asset system backend)
-    SDL_AsyncIOQueue* m_AsyncQueue;
+    // loaded assets go through the optional process stage on a worker before they can be indexed
+    TaskCounter m_ProcessTasks;
+    void OnAssetLoaded(AssetManagement::AsyncAssetEvent* asset);
+    static CallbackResult ProcessAsset(void* state);
+
+    // compressed assets are decompressed on a worker into the contextualized buffer, blocks in parallel
+    static CallbackResult DecompressAsset(void* state);
+
+    // actually asynchronous: every file read goes through the IO backend (this implementation assumes loose data; contain all IO code in here so we can swap out asset system backend)
+    std::unique_ptr<AssetManagement::IAssetIoBackend> m_IoBackend;
     bool LoadAssetFileAsync(AssetManagement::AsyncAssetEvent* destination);
+    bool CopyMappedAsset(AssetManagement::AsyncAssetEvent* destination);
     bool LoadEntityFileAsync(Pipeline::HashId id);
 
     // Queue an enetity to be loaded at the immediate next possible timing. Assets are loaded based on the implementation of engine (e.g. if eventually asseet bundles/packs are supported they'll go through that path)
-    void QueueEntity(Pipeline::HashId entityId);
+    // The entity replaces the world once read, so it supersedes every entity load still in flight; its assets are loaded with its priority.
+    void QueueEntity(Pipeline::HashId entityId, AssetManagement::LoadPriority priority = AssetManagement::LoadPriority::Visible);
 
-    size_t GetAssetSize(Pipeline::HashId assetId);
+    // the size an asset loads into; for compressed files that's the decompressed size, the file size goes to outCompressedSize
+    size_t GetAssetSize(Pipeline::HashId assetId, size_t* outCompressedSize);
+    static bool QueryAssetSize(SDL_Storage* storage, Pipeline::HashId assetId, size_t* outSize, size_t* outCompressedSize);
 
 public:
-    AssetManager(Engine::Core::Pipeline::ModuleAssembly modules, Logging::LoggerService *loggerService, ServiceTable *services);
+    AssetManager(Engine::Core::Pipeline::ModuleAssembly modules, const Configuration::ConfigurationProvider* configs, Logging::LoggerService *loggerService, ServiceTable *services);
     ~AssetManager();
 
     // Queue an individual asset to be loaded at the immeidate next possible timing. Assets are loaded as loose assets regardless of engine implementation.
-    void QueueAsset(Pipeline::HashId moduleId, Pipeline::HashId typeId, Pipeline::HashId assetId);
+    void QueueAsset(Pipeline::HashId moduleId, Pipeline::HashId typeId, Pipeline::HashId assetId, AssetManagement::LoadPriority priority = AssetManagement::LoadPriority::Critical);
+
+    // Stop loading an entity: a pending read of its file is discarded and its assets that nothing else references and
+    // that haven't been started yet are dropped.
+    void CancelEntity(Pipeline::HashId entityId);
 };
 
 }
\ No newline at end of file
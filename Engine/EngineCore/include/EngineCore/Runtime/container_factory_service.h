@@ -4,19 +4,31 @@
 #include "EngineCore/Containers/container_allocation_strategy.h"
 #include "EngineCore/Logging/logger.h"
 #include "EngineCore/Logging/logger_service.h"
-#include <cstdlib>
+#include "EngineCore/Runtime/heap_allocator.h"
+#include "EngineCore/Runtime/memory_tracker.h"
 
 namespace Engine::Core::Runtime {
 
+// container buffers live in the engine heap, which serves them from size class spans or its TLSF pools and grows them
+// in place while the block has room; they are counted as container memory, not heap memory
 class ContainerFactoryService : public Containers::IContainerAllocationStrategy
 {
 private:
+    // precedes every buffer, keeps it aligned for anything
+    struct BufferHeader
+    {
+        size_t Id;
+        size_t Size;
+    };
+
     Logging::Logger m_Logger;
+    HeapAllocator* m_HeapAllocator;
     size_t m_BufferCounter;
 
 public:
-    ContainerFactoryService(Logging::LoggerService* loggerService) 
+    ContainerFactoryService(Logging::LoggerService* loggerService, HeapAllocator* heapAllocator) 
         : m_Logger(loggerService->CreateLogger("ContainerFactoryService")),
+        m_HeapAllocator(heapAllocator),
         m_BufferCounter(0)
     {}
 
@@ -34,23 +46,31 @@ public:
 
     void* ToClientBuffer(void* buffer)
     {
-        return ((char*)buffer) + sizeof(size_t);
+        return ((char*)buffer) + sizeof(BufferHeader);
     }
 
     void* ToBufferHeader(void* buffer)
     {
-        return ((char*)buffer) - sizeof(size_t);
+        return ((char*)buffer) - sizeof(BufferHeader);
     }
 
 public:
+    // buffer traffic is only logged in debug builds, containers grow often enough to flood the log otherwise
     void* Allocate(size_t minimumCapacity)
     {
-        size_t actualAllocationSize = minimumCapacity + sizeof(size_t);
-        void* buffer = malloc(actualAllocationSize);
+        size_t actualAllocationSize = minimumCapacity + sizeof(BufferHeader);
+        void* buffer = m_HeapAllocator->Allocate(actualAllocationSize, EngineMemoryOwner, MemorySubsystem::Containers);
+        if (buffer == nullptr)
+        {
+            m_Logger.Error("Failed to allocate a container buffer of {} bytes.", minimumCapacity);
+            return nullptr;
+        }
 
         // allocate a buffer with a helper id buffer
-        *static_cast<size_t*>(buffer) = m_BufferCounter;
-        m_Logger.Information("Allocated buffer #{} for {} bytes.", m_BufferCounter, minimumCapacity);
+        *static_cast<BufferHeader*>(buffer) = { m_BufferCounter, minimumCapacity };
+#ifndef NDEBUG
+        m_Logger.Debug("Allocated buffer #{} for {} bytes.", m_BufferCounter, minimumCapacity);
+#endif
         m_BufferCounter ++;
 
         // calculate the client buffer
@@ -59,13 +79,25 @@ public:
 
     void* Reallocate(void* oldBuffer, size_t newSize)
     {
+        if (oldBuffer == nullptr)
+            return Allocate(newSize);
+
         // calculate the header contained buffer
         void* buffer = ToBufferHeader(oldBuffer);
-        size_t bufferId = *static_cast<size_t*>(buffer);
 
-        // reallocate
-        void* newBuffer = realloc(buffer, newSize + sizeof(size_t));
-        m_Logger.Information("Reallocated buffer #{} for {} bytes.", bufferId, newSize);
+        // stays where it is as long as the heap block has room, the tags move along otherwise
+        void* newBuffer = m_HeapAllocator->Realloc(buffer, newSize + sizeof(BufferHeader));
+        if (newBuffer == nullptr)
+        {
+            m_Logger.Error("Failed to grow container buffer #{} to {} bytes.", static_cast<BufferHeader*>(buffer)->Id, newSize);
+            return nullptr;
+        }
+
+        BufferHeader* header = static_cast<BufferHeader*>(newBuffer);
+#ifndef NDEBUG
+        m_Logger.Debug("Reallocated buffer #{} from {} to {} bytes.", header->Id, header->Size, newSize);
+#endif
+        header->Size = newSize;
 
         // calculate client buffer
         return ToClientBuffer(newBuffer);
@@ -73,10 +105,14 @@ public:
 
     void Free(void* clientBuffer)
     {
+        if (clientBuffer == nullptr)
+            return;
+
         void* buffer = ToBufferHeader(clientBuffer);
-        size_t bufferId = *static_cast<size_t*>(buffer);
-        free(buffer);
-        m_Logger.Information("Buffer #{} freed.", bufferId);
+#ifndef NDEBUG
+        m_Logger.Debug("Buffer #{} freed.", static_cast<BufferHeader*>(buffer)->Id);
+#endif
+        m_HeapAllocator->Deallocate(buffer);
     }
 };
 
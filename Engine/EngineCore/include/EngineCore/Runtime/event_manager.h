@@ -1,6 +1,8 @@
 #pragma once
 
 #include "EngineCore/Logging/logger.h"
+
+#include <type_traits>
 #include <vector>
 
 namespace Engine::Core::Logging {
@@ -21,6 +23,21 @@ class EventOwner
 {
 private:
     friend class EventWriter;
+    friend class EventStream;
+    friend class EventManager;
+    int m_ID = -1;
+};
+
+// events of a packed owner are stored without headers or author data, as plain arrays of TEvent that readers can
+// consume in batches
+template <typename TEvent>
+class PackedEventOwner
+{
+    static_assert(std::is_trivially_copyable_v<TEvent>, "packed events are copied as raw bytes");
+
+private:
+    friend class EventWriter;
+    friend class EventStream;
     friend class EventManager;
     int m_ID = -1;
 };
@@ -32,21 +49,32 @@ struct EventSystemInstance
     void* SystemLocalState;
 };
 
+struct EventSystemTask
+{
+    ServiceTable* Services;
+    const EventSystemInstance* System;
+    EventWriter* Writer;
+};
+
 class EventManager 
 {
 private:
     friend class EventWriter;
     friend class GameLoop;
 
-    EventManager(Logging::LoggerService* loggerService);
-
     int m_Registra = 0;
     std::vector<EventSystemInstance> m_Systems;
     Logging::Logger m_Logger;
 
-    bool ExecuteAllSystems(ServiceTable* services, EventWriter& writer);
+    // one writer per system so systems can run concurrently, readers go through them in registration order
+    std::vector<EventWriter> m_Writers;
+    std::vector<EventSystemTask> m_SystemTasks;
+
+    bool ExecuteAllSystems(ServiceTable* services);
 
 public:
+    EventManager(Logging::LoggerService* loggerService);
+
     // input events needs to be registered so event systems can access them
     template <typename TEvent>
     EventOwner<TEvent> RegisterInputEvent()
@@ -58,8 +86,30 @@ public:
         return owner;
     }
 
-    // event systems are stateless functions executed that transforms input events to output events
+    // packed events share the id space with regular input events
+    template <typename TEvent>
+    PackedEventOwner<TEvent> RegisterPackedEvent()
+    {
+        int id = m_Registra;
+        m_Registra++;
+        PackedEventOwner<TEvent> owner;
+        owner.m_ID = id;
+        return owner;
+    }
+
+    // event systems are stateless functions executed that transforms input events to output events; they are executed
+    // concurrently on the task manager, so they must not write to shared state
     void RegisterEventSystem(const EventSystemInstance* systems, size_t systemCount);
+
+    inline EventWriter* GetWriters()
+    {
+        return m_Writers.data();
+    }
+
+    inline size_t GetWriterCount() const
+    {
+        return m_Writers.size();
+    }
 };
 
 }
\ No newline at end of file
@@ -1,34 +1,170 @@
 #pragma once
 
+#include "EngineCore/Runtime/event_manager.h"
+
+#include <climits>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 
 namespace Engine::Core::Runtime 
 {
 
+class EventWriter;
+
+template <typename TEvent>
+class TypedEventStream;
+
+template <typename TEvent>
+class EventBatchStream;
+
+// author index of events whose author isn't known (packed events, or a full author table)
+constexpr uint16_t UnknownEventAuthor = UINT16_MAX;
+
 struct EventHeader
 {
-    void* Owner;
-    size_t Length;
+    uint16_t OwnerId;
 
-    const char* AuthorName;
-    int AuthorPath;
+    // index into the writer's author table
+    uint16_t Author;
+    uint32_t Length;
 };
 
+struct EventAuthor
+{
+    const char* Name;
+    int Path;
+};
+
+// reads the events of one or more writers in sequence, directly from their pages; events are grouped by owner, the
+// write order is kept between events of the same owner and the same writer
 class EventStream
 {
 private:
     friend class EventWriter;
 
-    const std::vector<unsigned char>* m_Data;
-    size_t m_Cursor = 0;
+    template <typename TEvent>
+    friend class TypedEventStream;
+
+    template <typename TEvent>
+    friend class EventBatchStream;
+
+    const EventWriter* m_Writers;
+    size_t m_WriterCount;
 
-    EventStream(const std::vector<unsigned char>* data) : m_Data(data) {}
+    // -1 walks every bucket
+    int m_BucketFilter;
+
+    size_t m_Writer = 0;
+    size_t m_Bucket = 0;
+    size_t m_Page = 0;
+    size_t m_Offset = 0;
+    bool m_Started = false;
+
+    EventStream(const EventWriter* writers, size_t writerCount, int bucketFilter)
+        : m_Writers(writers), m_WriterCount(writerCount), m_BucketFilter(bucketFilter)
+    {
+        if (bucketFilter >= 0)
+            m_Bucket = bucketFilter;
+    }
+
+    bool Seek();
+    bool MoveNextPage();
+    const unsigned char* GetCurrentEvent() const;
+    const unsigned char* GetCurrentPage(size_t* outSize) const;
+
+    inline EventStream FilterById(int id) const
+    {
+        // unregistered owners never have events, point them past every bucket
+        return EventStream(m_Writers, m_WriterCount, id < 0 ? INT_MAX : id);
+    }
 
 public:
     bool MoveNext();
     EventHeader GetCurrentHeader() const;
+    EventAuthor GetCurrentAuthor() const;
     const void* GetCurrentData() const;
+
+    // only visits the events of one owner, the cost doesn't depend on how many other events were written
+    template <typename TEvent>
+    TypedEventStream<TEvent> Filter(const EventOwner<TEvent>* owner) const
+    {
+        return TypedEventStream<TEvent>(FilterById(owner->m_ID));
+    }
+
+    template <typename TEvent>
+    EventBatchStream<TEvent> Filter(const PackedEventOwner<TEvent>* owner) const
+    {
+        return EventBatchStream<TEvent>(FilterById(owner->m_ID));
+    }
+};
+
+template <typename TEvent>
+class TypedEventStream
+{
+private:
+    friend class EventStream;
+
+    EventStream m_Stream;
+
+    TypedEventStream(EventStream stream) : m_Stream(stream) {}
+
+public:
+    inline bool MoveNext()
+    {
+        return m_Stream.MoveNext();
+    }
+
+    inline EventHeader GetCurrentHeader() const
+    {
+        return m_Stream.GetCurrentHeader();
+    }
+
+    inline EventAuthor GetCurrentAuthor() const
+    {
+        return m_Stream.GetCurrentAuthor();
+    }
+
+    inline const TEvent* GetCurrent() const
+    {
+        return (const TEvent*)m_Stream.GetCurrentData();
+    }
+};
+
+// yields contiguous arrays of packed events, one per page
+template <typename TEvent>
+class EventBatchStream
+{
+private:
+    friend class EventStream;
+
+    EventStream m_Stream;
+    const TEvent* m_Batch = nullptr;
+    size_t m_Count = 0;
+
+    EventBatchStream(EventStream stream) : m_Stream(stream) {}
+
+public:
+    inline bool MoveNext()
+    {
+        if (!m_Stream.MoveNextPage())
+            return false;
+
+        size_t size = 0;
+        m_Batch = (const TEvent*)m_Stream.GetCurrentPage(&size);
+        m_Count = size / sizeof(TEvent);
+        return true;
+    }
+
+    inline const TEvent* GetBatch() const
+    {
+        return m_Batch;
+    }
+
+    inline size_t GetCount() const
+    {
+        return m_Count;
+    }
 };
 
-}
\ No newline at end of file
+}
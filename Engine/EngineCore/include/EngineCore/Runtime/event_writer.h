@@ -3,65 +3,135 @@
 #include "EngineCore/Runtime/event_stream.h"
 #include "EngineCore/Runtime/event_manager.h"
 
+#include <vector>
+
 namespace Engine::Core::Runtime 
 {
 
 struct EventWriterCheckpoint
 {
-    size_t PrevLength;
+    size_t EventCount;
+};
+
+// events never straddle two pages, a page only holds whole events
+struct EventPage
+{
+    unsigned char* Data;
+    size_t Capacity;
+    size_t Used;
+};
+
+// all events of one owner (one event type) written by a writer
+struct EventBucket
+{
+    std::vector<EventPage> Pages;
+    size_t CurrentPage = 0;
+
+    // packed buckets hold bare event payloads of Stride bytes each
+    bool Packed = false;
+    size_t Stride = 0;
+};
+
+struct EventJournalEntry
+{
+    unsigned int Bucket;
+    unsigned int Size;
 };
 
 class EventWriter
 {
 private:
     friend class EventManager;
+    friend class EventStream;
     friend class GameLoop;
 
     const char* m_UserName = nullptr;
 
-    std::vector<unsigned char> m_Data;
+    // events are bucketed by owner id as they are written, so readers only walk the types they care about; pages live
+    // as long as the writer and are reused every frame, so writing never moves existing events
+    std::vector<EventBucket> m_Buckets;
+
+    // bucket and size of every event in write order, used to undo writes on rollback
+    std::vector<EventJournalEntry> m_Journal;
+
+    // author names and paths are referenced by index from the event headers; consecutive events of the same author
+    // share one entry
+    std::vector<EventAuthor> m_Authors;
+
+    // events of owners that were never registered (or whose id doesn't fit a header), the event manager reports the
+    // first ones of every writer
+    size_t m_DroppedEvents = 0;
+    bool m_DropsReported = false;
 
-    void Write(void* owner, const void* data, size_t length, const char* authorName, int authorPath);
+    void Write(int ownerId, const void* data, size_t length, const char* authorName, int authorPath);
+    void WritePacked(int ownerId, const void* data, size_t length);
+    EventBucket* GetBucket(int ownerId);
+    uint16_t GetAuthorIndex(const char* authorName, int authorPath);
+    unsigned char* Reserve(EventBucket& bucket, size_t totalLength);
 
     inline void Initialize()
     {
-        // clear the data stream to just a init block
-        m_Data.resize(sizeof(EventHeader));
-        EventHeader initialBlockHeader {
-            nullptr,
-            0,
-            nullptr,
-            0
-        };
-        memcpy(m_Data.data(), &initialBlockHeader, sizeof(EventHeader));
+        for (EventBucket& bucket : m_Buckets)
+        {
+            for (EventPage& page : bucket.Pages)
+            {
+                page.Used = 0;
+            }
+            bucket.CurrentPage = 0;
+        }
+        m_Journal.clear();
+        m_Authors.clear();
+        m_DroppedEvents = 0;
+    }
+
+    static inline size_t GetAlignedEventSize(size_t length)
+    {
+        // align to longest alignment
+        size_t totalLength = sizeof(EventHeader) + length - 1;
+        return totalLength - (totalLength % sizeof(size_t)) + sizeof(size_t);
     }
 
 public:
+    EventWriter() = default;
+    EventWriter(const EventWriter& other) = delete;
+    EventWriter(EventWriter&& other) noexcept;
+    ~EventWriter();
+
+    // owners that were never registered with the event manager have no bucket, their events are dropped with a warning
     template <typename TEvent>
     void WriteInputEvent(const EventOwner<TEvent>* owner, TEvent eventData, int authorPath)
     {
-        Write((void*)owner, &eventData, sizeof(TEvent), m_UserName, authorPath);
+        Write(owner->m_ID, &eventData, sizeof(TEvent), m_UserName, authorPath);
     }
 
-    inline EventStream OpenReadStream()
+    template <typename TEvent>
+    void WriteInputEvent(const PackedEventOwner<TEvent>* owner, const TEvent& eventData)
     {
-        return EventStream(&m_Data);
+        WritePacked(owner->m_ID, &eventData, sizeof(TEvent));
     }
 
-    inline bool HasEvents() const
+    inline EventStream OpenReadStream() const
     {
-        return m_Data.size() > sizeof(EventHeader);
+        return EventStream(this, 1, -1);
     }
 
-    inline EventWriterCheckpoint CreateCheckpoint() const 
+    // read several writers back to back without merging them
+    static inline EventStream OpenReadStream(const EventWriter* writers, size_t writerCount)
     {
-        return { m_Data.size() };
+        return EventStream(writers, writerCount, -1);
     }
 
-    inline void Rollback(EventWriterCheckpoint checkpoint)
+    inline bool HasEvents() const
+    {
+        return !m_Journal.empty();
+    }
+
+    inline EventWriterCheckpoint CreateCheckpoint() const 
     {
-        m_Data.resize(checkpoint.PrevLength);
+        return { m_Journal.size() };
     }
+
+    void Rollback(EventWriterCheckpoint checkpoint);
 };
 
-}
\ No newline at end of file
+}
@@ -15,6 +15,7 @@
 #include "EngineCore/Runtime/graphics_layer.h"
 #include "EngineCore/Runtime/heap_allocator.h"
 #include "EngineCore/Runtime/input_manager.h"
+#include "EngineCore/Runtime/memory_tracker.h"
 #include "EngineCore/Runtime/network_layer.h"
 #include "EngineCore/Runtime/service_table.h"
 #include "EngineCore/Runtime/task_manager.h"
@@ -46,6 +47,7 @@ public:
     virtual CallbackResult PollAsyncIoEvents() = 0;
 
     virtual CallbackResult BeginFrame() = 0;
+    virtual CallbackResult Tick() = 0;
     virtual CallbackResult Preupdate() = 0;
     virtual CallbackResult EventUpdate() = 0;
     virtual CallbackResult RenderPass() = 0;
@@ -65,6 +67,13 @@ private:
         GameLoop* m_Owner;
 
         Logging::LoggerService m_LoggerService;
+
+        // memory services go last, everything declared after them may still free into them while it's destroyed
+        MemoryTracker m_MemoryTracker;
+        TransientAllocator m_TransientAllocator;
+        HeapAllocator m_HeapAllocator;
+        ContainerFactoryService m_ContainerFactory;
+
         GraphicsLayer m_GraphicsLayer;
         WorldState m_WorldState;
         ModuleManager m_ModuleManager;
@@ -72,15 +81,19 @@ private:
         InputManager m_InputManager;
         NetworkLayer m_NetworkLayer;
         TaskManager m_TaskManager;
-        TransientAllocator m_TransientAllocator;
         AssetManager m_AssetManager;
-        HeapAllocator m_HeapAllocator;
-        ContainerFactoryService m_ContainerFactory;
         
         ServiceTable m_Services;
 
         Logging::Logger m_TopLevelLogger;
-        EventWriter m_EventWriter;
+
+        // runs every simulation step the world clock asks for, possibly none
+        CallbackResult Simulate();
+        static CallbackResult SimulateTask(void* state);
+
+        // hand the render callbacks a consistent view of the simulation; with a snapshot the next Simulate may run
+        // during the render pass
+        void PrepareRenderState(bool takeSnapshot);
 
     public:
         GameLoopController(Pipeline::ModuleAssembly modules, Configuration::ConfigurationProvider configs, GameLoop* owner);
@@ -93,6 +106,7 @@ private:
         CallbackResult ReloadAsset(Pipeline::HashId module, Pipeline::HashId type, Pipeline::HashId id) override;
         CallbackResult PollAsyncIoEvents() override;
         CallbackResult BeginFrame() override;
+        CallbackResult Tick() override;
         CallbackResult Preupdate() override;
         CallbackResult EventUpdate() override;
         CallbackResult RenderPass() override;
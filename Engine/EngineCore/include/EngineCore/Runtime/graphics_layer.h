@@ -18,6 +18,17 @@ namespace Engine::Core::Runtime {
 
 class GameLoop;
 
+// what the renderers asked for since start up, only counted in headless mode
+struct GraphicsCommandCounters
+{
+    size_t Frames = 0;
+    size_t RenderPasses = 0;
+    size_t DrawCalls = 0;
+    size_t Indices = 0;
+    size_t Uploads = 0;
+    size_t UploadedBytes = 0;
+};
+
 // Contains states and accesses to graphics related concepts, managed by the game loop.
 class GraphicsLayer
 {
@@ -32,6 +43,7 @@ private:
     SDL_GPUCommandBuffer* m_CommandBuffer = nullptr;
     SDL_GPUTexture* m_SwapchainTexture = nullptr;
     SDL_GPUTexture* m_DepthBuffer = nullptr;
+    GraphicsCommandCounters m_Counters;
     Logging::Logger m_Logger;
 
     // for game loop to directly control graphics behavior
@@ -50,8 +62,24 @@ public:
 
     inline SDL_GPUTexture* GetSharedDepthBuffer() const { return m_DepthBuffer; }
     inline SDL_GPUCommandBuffer* GetCurrentCommandBuffer() { return m_CommandBuffer; }
+    // returns null in headless mode, callers skip their GPU commands and report them through the Record functions
     SDL_GPURenderPass* AddRenderPass();
     void CommitRenderPass(SDL_GPURenderPass* pass);
+
+    inline bool IsHeadless() const { return m_Configs->Headless; }
+    inline const GraphicsCommandCounters& GetCommandCounters() const { return m_Counters; }
+
+    inline void RecordDrawCall(size_t indexCount)
+    {
+        m_Counters.DrawCalls++;
+        m_Counters.Indices += indexCount;
+    }
+
+    inline void RecordUpload(size_t size)
+    {
+        m_Counters.Uploads++;
+        m_Counters.UploadedBytes += size;
+    }
 };
 
 }
\ No newline at end of file
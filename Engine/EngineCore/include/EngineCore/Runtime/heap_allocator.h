@@ -1,39 +1,191 @@
 #pragma once
 
+#include "EngineCore/Runtime/memory_tracker.h"
+#include "EngineCore/Runtime/thread_cache.h"
+#include <atomic>
 #include <cstddef>
-#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace Engine::Core::Runtime {
 
+struct HeapStats
+{
+    // block sizes handed out, headers and size class rounding included
+    size_t AllocatedBytes;
+    size_t PeakAllocatedBytes;
+    size_t AllocationCount;
+
+    // memory taken from the system, and how much of it isn't handed out (free pool space, empty span slots)
+    size_t ReservedBytes;
+    size_t FragmentedBytes;
+
+    size_t ThreadHeapCount;
+};
+
+// the engine heap: small blocks come from size class spans, larger ones from a TLSF (two level segregated fit) pool,
+// both O(1); every thread allocates from a heap of its own without locking, a block freed on another thread is handed
+// back to its heap through a lock-free list; blocks too large for a pool go straight to the system
 class HeapAllocator
 {
-    // NOTE: temporary implementation
 public:
-    void* Allocate(size_t size)
+    static constexpr size_t SmallBlockLimit = 1024;
+    static constexpr size_t SpanSize = 64 * 1024;
+    static constexpr size_t PoolSize = 4 * 1024 * 1024;
+    static constexpr size_t HugeBlockThreshold = 1024 * 1024;
+
+private:
+    static constexpr int SizeClassCount = 20;
+    static constexpr int SlLog2 = 4;
+    static constexpr int SlCount = 1 << SlLog2;
+    static constexpr int MinBlockLog2 = 6;
+    static constexpr int FlCount = 20;
+    static constexpr ptrdiff_t UsageBatchBytes = 256 * 1024;
+
+    // the top bits of a block's size word tell whom and what the block was allocated for
+    static constexpr int MemoryOwnerShift = 56;
+    static constexpr int MemorySubsystemShift = 61;
+    static constexpr size_t SizeMask = (((size_t)1 << MemoryOwnerShift) - 1) & ~(size_t)15;
+    static_assert(MemoryTracker::MaxOwners <= 32 && MemorySubsystemCount <= 8, "memory tags don't fit in a block header");
+
+    // precedes every block; the low bits of the size are flags, sizes are multiples of 16
+    struct BlockHeader
     {
-        return malloc(size);   
-    }
+        void* Owner;
 
-    template <typename T>
-    T* Allocator(size_t count)
+        // only the owning heap writes it, other threads read it when they free the block
+        std::atomic<size_t> SizeAndFlags;
+
+        size_t GetSize() const { return SizeAndFlags.load(std::memory_order_relaxed) & SizeMask; }
+        MemoryOwner GetMemoryOwner() const { return (MemoryOwner)((SizeAndFlags.load(std::memory_order_relaxed) >> MemoryOwnerShift) & 31); }
+        MemorySubsystem GetMemorySubsystem() const { return (MemorySubsystem)(SizeAndFlags.load(std::memory_order_relaxed) >> MemorySubsystemShift); }
+        bool HasFlag(size_t flag) const { return (SizeAndFlags.load(std::memory_order_relaxed) & flag) != 0; }
+        void Set(size_t sizeAndFlags) { SizeAndFlags.store(sizeAndFlags, std::memory_order_relaxed); }
+    };
+
+    struct FreeBlock
     {
-        return Allocate(count * sizeof(T));
-    }
+        BlockHeader Header;
+        FreeBlock* Next;
+        FreeBlock* Previous;
+    };
 
-    void Deallocate(void* buffer)
+    struct ThreadHeap;
+
+    struct Span
     {
-        free(buffer);
-    }
+        ThreadHeap* Heap;
+        int SizeClass;
+        size_t BlockStride;
+        size_t Used;
+        void* FreeList;
+        unsigned char* Bump;
+        unsigned char* End;
+        Span* Next;
+        Span* Previous;
+        bool Partial;
+    };
+
+    struct SizeClassState
+    {
+        Span* Current = nullptr;
+        Span* Partial = nullptr;
+    };
+
+    struct ThreadHeap
+    {
+        std::thread::id Thread;
+
+        // TLSF free lists, a bit is set for every non-empty list
+        uint32_t FlBitmap = 0;
+        uint32_t SlBitmap[FlCount] = {};
+        FreeBlock* FreeLists[FlCount][SlCount] = {};
+        std::vector<void*> Pools;
 
-    void* Realloc(void* buffer, size_t newSize)
+        SizeClassState Classes[SizeClassCount];
+
+        // blocks freed by other threads, taken as a whole by the owner
+        std::atomic<BlockHeader*> RemoteFrees { nullptr };
+
+        // counted by the thread itself, frees included whichever heap the block came from; bytes are published to
+        // the totals in batches, so the peak is only as exact as the batch size
+        std::atomic<ptrdiff_t> AllocationCount { 0 };
+        std::atomic<ptrdiff_t> UnpublishedBytes { 0 };
+        std::atomic<size_t> ReservedBytes { 0 };
+    };
+
+    MemoryTracker* m_MemoryTracker;
+
+    std::mutex m_Mutex;
+    std::vector<std::unique_ptr<ThreadHeap>> m_Heaps;
+
+    std::atomic<size_t> m_HugeBytes;
+    std::atomic<size_t> m_HugeCount;
+    std::atomic<size_t> m_AllocatedBytes;
+    std::atomic<size_t> m_PeakAllocatedBytes;
+
+    static int SizeClassOf(size_t size);
+    static size_t SizeOfClass(int sizeClass);
+    static void MapSize(size_t size, int* outFl, int* outSl);
+
+    ThreadCacheKey m_CacheKey;
+    static thread_local ThreadCache<ThreadHeap> s_CachedHeap;
+
+    ThreadHeap* GetThreadHeap();
+    void TrackUsage(ThreadHeap* heap, ptrdiff_t bytes, ptrdiff_t count);
+    void PublishUsage(ptrdiff_t bytes);
+    void DrainRemoteFrees(ThreadHeap* heap);
+    void FreeLocal(ThreadHeap* heap, BlockHeader* header);
+
+    void* AllocateSmall(ThreadHeap* heap, int sizeClass);
+    void FreeSmall(ThreadHeap* heap, BlockHeader* header);
+
+    BlockHeader* AllocateBlock(ThreadHeap* heap, size_t blockSize);
+    void FreeBlockLocal(ThreadHeap* heap, BlockHeader* header);
+    bool AddPool(ThreadHeap* heap);
+    void InsertFreeBlock(ThreadHeap* heap, FreeBlock* block);
+    void RemoveFreeBlock(ThreadHeap* heap, FreeBlock* block);
+
+public:
+    HeapAllocator(MemoryTracker* memoryTracker);
+    ~HeapAllocator();
+
+    HeapAllocator(const HeapAllocator&) = delete;
+    HeapAllocator& operator=(const HeapAllocator&) = delete;
+
+    // the block is counted against the owner until it's freed, reallocating it keeps the owner; services building on
+    // the heap count their blocks under their own subsystem
+    void* Allocate(size_t size, MemoryOwner owner = EngineMemoryOwner, MemorySubsystem subsystem = MemorySubsystem::EngineHeap);
+
+    template <typename T>
+    T* Allocate(size_t count, MemoryOwner owner = EngineMemoryOwner)
     {
-        return realloc(buffer, newSize);
+        return static_cast<T*>(Allocate(count * sizeof(T), owner));
     }
 
+    // any thread may free any block
+    void Deallocate(void* buffer);
+
+    void* Realloc(void* buffer, size_t newSize);
+
     template <typename T>
     T* Realloc(T* buffer, size_t count)
     {
-        return Realloc((void*)buffer, count * sizeof(T));
+        return static_cast<T*>(Realloc(static_cast<void*>(buffer), count * sizeof(T)));
     }
+
+    // bytes the block can hold, at least what it was allocated with
+    size_t GetUsableSize(const void* buffer) const;
+
+    // puts back the blocks other threads freed into the calling thread's heap, which otherwise only happens when it
+    // allocates or frees; the game loop calls it at the end of every frame
+    void EndFrame();
+
+    // totals over every thread, slightly behind while other threads are allocating
+    HeapStats GetStats();
 };
 
-}
\ No newline at end of file
+}
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "EngineCore/AssetManagement/async_io_event.h"
-#include "EngineCore/Logging/logger.h"
-#include "EngineCore/Runtime/crash_dump.h"
-#include "EngineCore/Runtime/service_table.h"
 #include "EngineCore/Runtime/transient_allocator.h"
 
+#include <cstddef>
+
 namespace Engine::Core::Runtime {
 
+// the events of one batch of contextualized assets, they live in a single transient buffer that is returned once every
+// one of them was indexed or skipped; the asset manager decides the order they are indexed in
 class IndexQueue
 {
 private:
@@ -15,44 +16,38 @@ private:
 
     AssetManagement::AsyncAssetEvent* m_Buffer;
     size_t m_Count;
-    size_t m_PendingPosition;
-    
-    IndexQueue* m_Next;
-
-    Logging::Logger m_Logger;
-    Runtime::ServiceTable* m_Services;
+    size_t m_FinishedCount;
 
 public:
-    IndexQueue(TransientBufferId bufferId, AssetManagement::AsyncAssetEvent* buffer, size_t count, const Logging::Logger& logger, Runtime::ServiceTable* services);
+    IndexQueue(TransientBufferId bufferId, AssetManagement::AsyncAssetEvent* buffer, size_t count);
 
-    inline TransientBufferId GetBufferId()
+    inline TransientBufferId GetBufferId() const
     {
         return m_BufferId;
     }
 
-    inline IndexQueue* GetNext() 
+    inline size_t GetCount() const
+    {
+        return m_Count;
+    }
+
+    inline AssetManagement::AsyncAssetEvent* GetEvent(size_t index)
     {
-        return m_Next;
+        return &m_Buffer[index];
     }
 
-    inline void AddTail(IndexQueue* tail)
+    inline void MarkFinished()
     {
-        if (m_Next == nullptr)
-        {
-            m_Next = tail;
-        }
-        else 
-        {
-            m_Next->AddTail(tail);
-        }
+        m_FinishedCount++;
     }
 
     inline bool IsCompleted() const 
     {
-        return m_PendingPosition >= m_Count;
+        return m_FinishedCount >= m_Count;
     }
 
-    Runtime::CallbackResult Flush();
+    // the events are placed into the transient buffer, they have to be destroyed before it's returned
+    void DestroyEvents();
 };
 
-}
\ No newline at end of file
+}
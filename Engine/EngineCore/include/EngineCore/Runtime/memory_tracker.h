@@ -0,0 +1,139 @@
+#pragma once
+
+#include "EngineCore/Configuration/configuration_provider.h"
+#include "EngineCore/Logging/logger.h"
+#include "EngineCore/Runtime/thread_cache.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Engine::Core::Logging {
+    class LoggerService;
+}
+
+namespace Engine::Core::Runtime {
+
+enum class MemorySubsystem : unsigned char
+{
+    TransientBuffers,
+    EngineHeap,
+    Containers,
+    GpuBuffers,
+    Scripting
+};
+
+constexpr int MemorySubsystemCount = 5;
+
+// who an allocation is made for, modules register one each; everything else belongs to the engine
+using MemoryOwner = unsigned int;
+constexpr MemoryOwner EngineMemoryOwner = 0;
+
+struct MemoryUsage
+{
+    size_t LiveBytes;
+    size_t LiveCount;
+
+    // sampled at the end of every frame, memory allocated and freed within a frame only shows up in the frame counters
+    size_t PeakBytes;
+
+    // the last finished frame
+    size_t FrameAllocations;
+    size_t FrameFrees;
+    size_t FrameAllocatedBytes;
+};
+
+// tags every allocation the engine services make with a subsystem and an owner; threads count into blocks of their own
+// without locking, the totals are gathered once per frame along with the budget checks
+class MemoryTracker
+{
+public:
+    static constexpr MemoryOwner MaxOwners = 32;
+
+private:
+    // running totals only ever written by their thread
+    struct Counters
+    {
+        std::atomic<size_t> Allocations { 0 };
+        std::atomic<size_t> Frees { 0 };
+        std::atomic<size_t> AllocatedBytes { 0 };
+        std::atomic<size_t> FreedBytes { 0 };
+    };
+
+    struct ThreadCounters
+    {
+        std::thread::id Thread;
+        Counters Owners[MemorySubsystemCount][MaxOwners];
+    };
+
+    struct Snapshot
+    {
+        size_t Allocations = 0;
+        size_t Frees = 0;
+        size_t AllocatedBytes = 0;
+        size_t FreedBytes = 0;
+    };
+
+    Logging::Logger m_Logger;
+    size_t m_Budgets[MemorySubsystemCount];
+    bool m_OverBudget[MemorySubsystemCount];
+
+    std::mutex m_Mutex;
+    std::vector<std::unique_ptr<ThreadCounters>> m_Threads;
+    std::vector<std::string> m_OwnerNames;
+
+    // gathered by EndFrame
+    Snapshot m_Totals[MemorySubsystemCount][MaxOwners];
+    MemoryUsage m_Usage[MemorySubsystemCount][MaxOwners];
+    MemoryUsage m_SubsystemUsage[MemorySubsystemCount];
+
+    ThreadCacheKey m_CacheKey;
+    static thread_local ThreadCache<ThreadCounters> s_CachedCounters;
+
+    ThreadCounters* GetThreadCounters();
+
+    static void Add(std::atomic<size_t>& counter, size_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+public:
+    MemoryTracker(const Configuration::ConfigurationProvider* configs, Logging::LoggerService* loggerService);
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    // a name registered before gets its old owner back, so reloaded modules keep counting into the same place
+    MemoryOwner RegisterOwner(const char* name);
+    const char* GetOwnerName(MemoryOwner owner);
+
+    void TrackAllocation(MemorySubsystem subsystem, MemoryOwner owner, size_t bytes)
+    {
+        Counters& counters = GetThreadCounters()->Owners[(int)subsystem][owner < MaxOwners ? owner : EngineMemoryOwner];
+        Add(counters.Allocations, 1);
+        Add(counters.AllocatedBytes, bytes);
+    }
+
+    // frees may happen on any thread, not only the one that allocated
+    void TrackFree(MemorySubsystem subsystem, MemoryOwner owner, size_t bytes)
+    {
+        Counters& counters = GetThreadCounters()->Owners[(int)subsystem][owner < MaxOwners ? owner : EngineMemoryOwner];
+        Add(counters.Frees, 1);
+        Add(counters.FreedBytes, bytes);
+    }
+
+    // main thread only, once per frame: gathers usage and raises budget alarms
+    void EndFrame();
+
+    // as of the last EndFrame
+    MemoryUsage GetUsage(MemorySubsystem subsystem, MemoryOwner owner) const;
+    MemoryUsage GetSubsystemUsage(MemorySubsystem subsystem) const;
+
+    // logs everything still allocated, meant for after the modules are unloaded; returns the number of live allocations
+    size_t ReportLeaks();
+};
+
+}
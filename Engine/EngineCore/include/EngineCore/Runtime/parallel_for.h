@@ -0,0 +1,81 @@
+#pragma once
+
+#include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/task_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace Engine::Core::Runtime {
+
+// processes the half-open index range [begin, end)
+using ParallelForDelegate = CallbackResult(*)(void* state, size_t begin, size_t end);
+
+// at most this many runners take part in one reduction, their partial results live on the caller's stack
+constexpr size_t MaxReduceRunners = 64;
+
+// splits [begin, end) into chunks of grainSize indices that idle runners claim one at a time; no per-chunk allocation
+// is made, and the call returns once the whole range was processed (or the first error, after every runner stopped)
+CallbackResult ParallelFor(ITaskScheduler* scheduler, size_t begin, size_t end, size_t grainSize, ParallelForDelegate routine, void* state);
+
+template <typename T>
+struct ParallelReduceContext
+{
+    T (*Map)(void* state, size_t begin, size_t end, T accumulator);
+    T (*Combine)(T left, T right);
+    void* State;
+    T Identity;
+    size_t Begin;
+    size_t End;
+    size_t GrainSize;
+    std::atomic<size_t> NextChunk;
+    T Partials[MaxReduceRunners];
+
+    static CallbackResult Runner(void* state, size_t runnerIndex)
+    {
+        auto context = (ParallelReduceContext<T>*)state;
+
+        T accumulator = context->Identity;
+        while (true)
+        {
+            size_t chunkBegin = context->Begin + context->NextChunk.fetch_add(1, std::memory_order_relaxed) * context->GrainSize;
+            if (chunkBegin >= context->End)
+                break;
+
+            size_t chunkEnd = std::min(chunkBegin + context->GrainSize, context->End);
+            accumulator = context->Map(context->State, chunkBegin, chunkEnd, accumulator);
+        }
+
+        context->Partials[runnerIndex] = accumulator;
+        return CallbackSuccess();
+    }
+};
+
+// map folds a chunk into the runner's accumulator, combine merges the per-runner results on the calling thread; chunks
+// are claimed dynamically, so combine should be associative and commutative
+template <typename T>
+T ParallelReduce(ITaskScheduler* scheduler, size_t begin, size_t end, size_t grainSize, T identity, T (*map)(void* state, size_t begin, size_t end, T accumulator), T (*combine)(T left, T right), void* state)
+{
+    if (end <= begin)
+        return identity;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+    size_t runnerCount = std::min({ chunkCount, scheduler->GetConcurrency(), MaxReduceRunners });
+
+    if (runnerCount <= 1)
+        return map(state, begin, end, identity);
+
+    ParallelReduceContext<T> context { map, combine, state, identity, begin, end, grainSize, { 0 } };
+    scheduler->RunConcurrently(ParallelReduceContext<T>::Runner, &context, runnerCount);
+
+    T result = context.Partials[0];
+    for (size_t i = 1; i < runnerCount; i++)
+    {
+        result = combine(result, context.Partials[i]);
+    }
+    return result;
+}
+
+}
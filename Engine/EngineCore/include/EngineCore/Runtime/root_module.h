@@ -31,11 +31,37 @@ struct RootModuleState
     std::unordered_map<int, Ecs::Components::SpatialRelation> SpatialComponents;
     std::vector<Ecs::Components::Camera> CameraComponents;
 
+    // spatial relations as they were before the current simulation step, used to interpolate rendering; only entities
+    // the step moved are in here, copying every relation each step would cost more than the interpolation itself
+    std::unordered_map<int, Ecs::Components::SpatialRelation> PreviousSpatialComponents;
+
+    // copy of the render relevant state taken at the frame boundary, only filled when the simulation of the next frame
+    // runs while the current one renders
+    std::unordered_map<int, Ecs::Components::SpatialRelation> SnapshotSpatialComponents;
+    std::unordered_map<int, Ecs::Components::SpatialRelation> SnapshotPreviousSpatialComponents;
+    std::vector<Ecs::Components::Camera> SnapshotCameraComponents;
+
     // output events
     std::optional<TickEventData> TickEvent;
 
     // input events
-    EventOwner<TransformUpdateEventData> TransformUpdateEventOwner;
+    PackedEventOwner<TransformUpdateEventData> TransformUpdateEventOwner;
+
+    // called by the game loop between simulation and rendering; with a snapshot the renderer reads copies, so the
+    // simulation is free to modify the live state while the frame renders
+    void PrepareRenderState(float interpolationAlpha, bool takeSnapshot);
+
+    // the spatial relation to render, blended between the previous and the current simulation step
+    bool GetRenderSpatial(int entity, Ecs::Components::SpatialRelation* outRelation) const;
+
+    inline const std::vector<Ecs::Components::Camera>& GetRenderCameras() const
+    {
+        return m_UseSnapshot ? SnapshotCameraComponents : CameraComponents;
+    }
+
+private:
+    bool m_UseSnapshot = false;
+    float m_RenderAlpha = 1;
 };
 
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ class TransientAllocator;
 class AssetManager;
 class ContainerFactoryService;
 class HeapAllocator;
+class MemoryTracker;
 
 // Table of services that should be accessed to modules.
 struct ServiceTable 
@@ -33,6 +34,7 @@ struct ServiceTable
     AssetManager* AssetManager;
     HeapAllocator* HeapAllocator;
     ContainerFactoryService* ContainerFactory;
+    MemoryTracker* MemoryTracker;
 };
 
 }
\ No newline at end of file
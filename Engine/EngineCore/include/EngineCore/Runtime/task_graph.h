@@ -0,0 +1,76 @@
+#pragma once
+
+#include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/task_scheduler.h"
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+namespace Engine::Core::Runtime {
+
+class TaskManager;
+
+// a set of jobs with predecessor edges; each job is handed to the scheduler as soon as the last of its predecessors
+// finished, so independent chains don't wait on each other. the graph must outlive its execution, and can be dispatched
+// again once the previous run completed.
+class TaskGraph
+{
+private:
+    struct Node
+    {
+        TaskGraph* Owner;
+        GenericTaskDelegate Routine;
+        void* State;
+        GenericTaskDelegate Continuation;
+        void* ContinuationState;
+        std::vector<size_t> Successors;
+        size_t PredecessorCount;
+        std::atomic<size_t> RemainingPredecessors;
+
+        Node(TaskGraph* owner, GenericTaskDelegate routine, void* state)
+            : Owner(owner),
+            Routine(routine),
+            State(state),
+            Continuation(nullptr),
+            ContinuationState(nullptr),
+            PredecessorCount(0),
+            RemainingPredecessors(0)
+        {
+        }
+    };
+
+    // deque keeps node addresses stable, they are passed to the scheduler as task state
+    std::deque<Node> m_Nodes;
+    ITaskScheduler* m_Scheduler;
+    std::atomic<bool> m_Failed;
+
+    static CallbackResult RunNode(void* state);
+    CallbackResult Prepare();
+
+public:
+    TaskGraph();
+
+    // returns the id used to declare edges
+    size_t AddJob(GenericTaskDelegate routine, void* state);
+
+    // the successor won't start before the predecessor (and its continuation) finished
+    void AddDependency(size_t predecessor, size_t successor);
+
+    // runs on the same thread right after the job succeeded, before any successor is released
+    void SetContinuation(size_t job, GenericTaskDelegate continuation, void* state);
+
+    // schedule every job without predecessors; when called from inside a task the whole graph is tracked by that
+    // task's counter, so the enclosing join also waits for the graph
+    CallbackResult Dispatch(ITaskScheduler* scheduler);
+
+    // dispatch and wait for the graph from a thread outside the task system (e.g. the main thread)
+    CallbackResult Run(TaskManager* taskManager);
+
+    inline size_t GetJobCount() const
+    {
+        return m_Nodes.size();
+    }
+};
+
+}
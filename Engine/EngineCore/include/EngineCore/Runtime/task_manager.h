@@ -6,28 +6,45 @@
 #include "EngineCore/Runtime/module_manager.h"
 #include "EngineCore/Runtime/task_scheduler.h"
 #include "SDL3/SDL_thread.h"
-#include "blockingconcurrentqueue.h"
 #include "lightweightsemaphore.h"
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace Engine::Core::Runtime {
-    
+
 class EventWriter;
+class TaskManager;
 
-enum class TaskType 
+enum class TaskType
 {
-    ShutDown,
     ProcessInputEvents,
     GenericTask
 };
 
-struct Task 
+// tracks a batch of scheduled tasks; every task scheduled from inside a tracked task is added to the same counter, so
+// joining on it waits for the whole tree of work to finish
+struct TaskCounter
+{
+    std::atomic<size_t> Pending { 0 };
+    std::atomic<bool> Failed { false };
+
+    // only the first failure is kept, read it after the counter drained
+    CallbackResult Error;
+};
+
+struct Task
 {
     TaskType Type;
+    TaskCounter* Counter;
 
     union {
         struct {
             InstancedEventCallback Routine;
-            EventWriter* EventWriters; 
+            EventWriter* EventWriters;
             size_t EventWriterCount;
         } ProcessInputEventsTask;
 
@@ -38,20 +55,33 @@ struct Task
     } Payload;
 };
 
-struct TaskResult 
-{
-    CallbackResult Result;
-    size_t AdditionalTasks;
-};
-
-class TaskManager
+// work-stealing task manager: each worker owns a deque it pops from the back (most recently pushed, likely still in
+// cache), idle workers steal from the front of other deques; threads that are not workers (the main thread) share one
+// extra deque and help executing tasks while they wait for a join
+class TaskManager : public ITaskScheduler
 {
 private:
+    struct WorkQueue
+    {
+        std::mutex Lock;
+        std::deque<Task> Tasks;
+    };
+
+    struct WorkerContext
+    {
+        TaskManager* Owner;
+        size_t QueueIndex;
+    };
+
     std::vector<SDL_Thread*> m_WorkerThreads;
+    std::vector<WorkerContext> m_WorkerContexts;
+
+    // one queue per worker, the last one is shared by all external threads
+    std::unique_ptr<WorkQueue[]> m_Queues;
+    size_t m_QueueCount;
 
-    moodycamel::LightweightSemaphore m_TerminationSignal;
-    moodycamel::BlockingConcurrentQueue<Task> m_TaskQueue;
-    moodycamel::BlockingConcurrentQueue<TaskResult> m_ResultQueue;
+    std::atomic<bool> m_ShuttingDown;
+    moodycamel::LightweightSemaphore m_WorkAvailable;
 
     ServiceTable* m_ServiceTable;
     Logging::Logger m_Logger;
@@ -59,26 +89,36 @@ private:
 
     static int ThreadRoutine(void* state);
 
+    size_t GetLocalQueueIndex() const;
+    bool TryPopLocal(size_t queueIndex, Task& outTask);
+    bool TrySteal(size_t thiefIndex, Task& outTask);
+    bool TryRunOne();
+    void Execute(const Task& task);
+
 public:
     TaskManager(ServiceTable* services, Logging::LoggerService* loggerService, size_t workerCount);
     ~TaskManager();
 
-    inline void ScheduleWork(const Task& task)
-    {
-        m_TaskQueue.enqueue(task);
-    }
-    
-    inline void ScheduleWork(const Task&& task)
+    // schedule a task onto the calling thread's queue; the counter may be null for detached work
+    void ScheduleWork(Task task, TaskCounter* counter);
+
+    // wait for every task tracked by the counter, executing queued work on the calling thread in the mean time
+    CallbackResult Join(TaskCounter* counter);
+
+    // child tasks are tracked by the counter of the task that schedules them
+    void ScheduleTask(GenericTaskDelegate routine, void* state) override;
+
+    CallbackResult RunConcurrently(ConcurrentTaskDelegate routine, void* state, size_t runnerCount) override;
+
+    inline size_t GetConcurrency() const override
     {
-        m_TaskQueue.enqueue(task);
+        return m_WorkerThreads.size() + 1;
     }
 
-    inline TaskResult WaitOne()
+    inline size_t GetWorkerCount() const
     {
-        TaskResult result;
-        m_ResultQueue.wait_dequeue(result);
-        return result;
+        return m_WorkerThreads.size();
     }
 };
 
-}
\ No newline at end of file
+}
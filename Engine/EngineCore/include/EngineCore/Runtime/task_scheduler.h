@@ -2,14 +2,25 @@
 
 #include "EngineCore/Runtime/crash_dump.h"
 
+#include <cstddef>
+
 namespace Engine::Core::Runtime {
 
 using GenericTaskDelegate = CallbackResult(*)(void* state);
 
+// runner index is unique per call and smaller than the runner count
+using ConcurrentTaskDelegate = CallbackResult(*)(void* state, size_t runnerIndex);
+
 class ITaskScheduler
 {
 public:
     virtual void ScheduleTask(GenericTaskDelegate routine, void* state) = 0;
+
+    // run the routine on up to runnerCount threads, the calling one included, and return once all of them finished
+    virtual CallbackResult RunConcurrently(ConcurrentTaskDelegate routine, void* state, size_t runnerCount) = 0;
+
+    // number of threads that can execute tasks at the same time
+    virtual size_t GetConcurrency() const = 0;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Engine::Core::Runtime {
+
+// services that hand every thread a block of its own (arenas, heaps, counters) remember the last one a thread used;
+// the cache is keyed on an id no other instance ever gets again, an address could come back for a new instance while
+// the cache still points into the old one
+class ThreadCacheKey
+{
+private:
+    static inline std::atomic<uint64_t> s_NextId { 1 };
+    uint64_t m_Id;
+
+public:
+    ThreadCacheKey() : m_Id(s_NextId.fetch_add(1, std::memory_order_relaxed)) {}
+
+    ThreadCacheKey(const ThreadCacheKey&) = delete;
+    ThreadCacheKey& operator=(const ThreadCacheKey&) = delete;
+
+    uint64_t GetId() const { return m_Id; }
+};
+
+// meant to be a thread_local, one per service type
+template <typename T>
+class ThreadCache
+{
+private:
+    uint64_t m_Key = 0;
+    T* m_Value = nullptr;
+
+public:
+    // nullptr unless the last store on this thread was for the same instance
+    T* Find(const ThreadCacheKey& key) const { return m_Key == key.GetId() ? m_Value : nullptr; }
+
+    void Store(const ThreadCacheKey& key, T* value)
+    {
+        m_Key = key.GetId();
+        m_Value = value;
+    }
+};
+
+}
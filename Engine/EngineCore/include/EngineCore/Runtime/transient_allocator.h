@@ -1,7 +1,13 @@
 #pragma once
 
 #include "EngineCore/Logging/logger.h"
+#include "EngineCore/Runtime/memory_tracker.h"
+#include "EngineCore/Runtime/thread_cache.h"
+#include <atomic>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace Engine::Core::Logging {
@@ -14,29 +20,101 @@ struct TransientBufferId
 {
     int Parent;
     int Child;
-};
 
-struct AllocatedBuffer
-{
-    void* Buffer = nullptr;
-    int ChildCount = 0;
+    // bumped every time the group's slot is reused, ids of a returned group stop resolving
+    unsigned int Generation;
 };
 
+// safe to use from any thread: every thread bump allocates from an arena of its own, and buffers can be returned (and
+// read) on any thread, the last child returned frees the group wherever that happens
 class TransientAllocator
 {
+public:
+    // groups are bump allocated from pages this large, bigger groups get a page of their own
+    static constexpr size_t PageSize = 16 * 1024 * 1024;
+
+    // emptied pages kept for the next groups instead of going back to the system
+    static constexpr size_t SparePageCount = 2;
+
+    // same as malloc, so a group is aligned for anything
+    static constexpr size_t GroupAlignment = 16;
+
+    // group slots are handed to arenas a chunk at a time; chunks never move, so ids resolve without locking
+    static constexpr int GroupChunkSize = 1024;
+    static constexpr int MaxGroupChunks = 1024;
+
 private:
+    struct Page
+    {
+        unsigned char* Memory = nullptr;
+        size_t Size = 0;
+
+        // only touched by the arena allocating from the page
+        size_t Used = 0;
+
+        // groups in the page, plus one while it's an arena's current page; the page is reclaimed when it drops to zero
+        std::atomic<int> LiveGroups { 0 };
+    };
+
+    struct ThreadArena;
+
+    struct BufferGroup
+    {
+        unsigned char* Buffer = nullptr;
+        Page* OwnerPage = nullptr;
+        ThreadArena* Arena = nullptr;
+        size_t Size = 0;
+        MemoryOwner Owner = EngineMemoryOwner;
+        int NextFree = -1;
+        std::atomic<int> ChildCount { 0 };
+        std::atomic<unsigned int> Generation { 0 };
+    };
+
+    // groups returned on any thread are pushed onto their arena's returned list, the arena takes the whole list
+    // at once when it runs out of free slots
+    struct ThreadArena
+    {
+        std::thread::id Thread;
+        Page* CurrentPage = nullptr;
+        std::vector<int> FreeGroups;
+        std::atomic<int> ReturnedGroups { -1 };
+    };
+
     Logging::Logger m_Logger;
-    std::vector<AllocatedBuffer> m_Buffers;
+    MemoryTracker* m_MemoryTracker;
+
+    // pages and arenas are only created and reclaimed under the lock, which is once per page or thread
+    std::mutex m_Mutex;
+    std::vector<std::unique_ptr<Page>> m_Pages;
+    std::vector<Page*> m_SparePages;
+    std::vector<std::unique_ptr<ThreadArena>> m_Arenas;
+
+    std::atomic<BufferGroup*> m_GroupChunks[MaxGroupChunks];
+    int m_GroupChunkCount;
+
+    ThreadCacheKey m_CacheKey;
+    static thread_local ThreadCache<ThreadArena> s_CachedArena;
+
+    ThreadArena* GetThreadArena();
+    Page* AcquirePage(size_t size);
+    void ReleasePage(Page* page);
+    int ClaimGroupSlot(ThreadArena* arena);
+    BufferGroup* ResolveGroup(int slot) const;
+    BufferGroup* FindGroup(TransientBufferId id, const char* action);
 
 public:
-    TransientAllocator(Logging::LoggerService* loggerService);
+    TransientAllocator(Logging::LoggerService* loggerService, MemoryTracker* memoryTracker);
+    ~TransientAllocator();
+
+    TransientAllocator(const TransientAllocator&) = delete;
+    TransientAllocator& operator=(const TransientAllocator&) = delete;
+
+    // returns the id of the first buffer; the group is counted against the owner until its last child is returned
+    TransientBufferId CreateBufferGroup(size_t totalSize, int childCount, MemoryOwner owner = EngineMemoryOwner);
 
-    // returns the id of the first buffer
-    TransientBufferId CreateBufferGroup(size_t totalSize, int childCount);
-    
     void Return(TransientBufferId id);
-    
+
     void *GetBuffer(TransientBufferId id);
 };
 
-}
\ No newline at end of file
+}
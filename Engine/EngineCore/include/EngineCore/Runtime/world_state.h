@@ -2,6 +2,7 @@
 
 #include "EngineCore/Ecs/entity.h"
 #include "EngineUtils/Memory/memstream_lite.h"
+#include "SDL3/SDL_stdinc.h"
 
 #include <glm/glm.hpp>
 #include <vector>
@@ -25,9 +26,18 @@ private:
     Configuration::ConfigurationProvider* m_Configs;
     std::vector<Ecs::Entity> m_Entities;
 
+    // simulated time, advanced one step at a time
     float m_TotalTime = 0;
     float m_DeltaTime = 0;
+
+    // real time not yet consumed by simulation steps
+    Uint64 m_LastTicks = 0;
+    float m_Accumulator = 0;
+    float m_InterpolationAlpha = 1;
+    bool m_VariableStepPending = false;
+
     void Tick();
+    bool NextStep();
 
     WorldState(Configuration::ConfigurationProvider* configs) : m_Configs(configs) {}
 
@@ -46,6 +56,12 @@ public:
     {
         return m_DeltaTime;
     }
+
+    // how far the rendered frame is between the previous simulation step (0) and the latest one (1)
+    inline float GetInterpolationAlpha() const
+    {
+        return m_InterpolationAlpha;
+    }
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "EngineCore/AssetManagement/asset_archive.h"
+
+#include <algorithm>
+
+using namespace Engine::Core::AssetManagement;
+
+bool AssetArchive::Open(const char* path)
+{
+    m_Entries = nullptr;
+    m_EntryCount = 0;
+
+    if (!m_File.Open(path))
+        return false;
+
+    size_t fileSize = m_File.GetSize();
+    const AssetArchiveHeader* header = static_cast<const AssetArchiveHeader*>(m_File.GetData());
+    if (fileSize < sizeof(AssetArchiveHeader)
+        || header->MagicWord != AssetArchiveMagicWord
+        || header->Version != AssetArchiveVersion
+        || header->EntryCount > (fileSize - sizeof(AssetArchiveHeader)) / sizeof(AssetArchiveEntry))
+    {
+        m_File.Close();
+        return false;
+    }
+
+    // reject the whole archive if any blob points outside the file, nothing needs to be checked on lookup afterwards
+    const AssetArchiveEntry* entries = reinterpret_cast<const AssetArchiveEntry*>(header + 1);
+    for (uint64_t i = 0; i < header->EntryCount; i++)
+    {
+        if (entries[i].Offset > fileSize || entries[i].Size > fileSize - entries[i].Offset)
+        {
+            m_File.Close();
+            return false;
+        }
+    }
+
+    m_Entries = entries;
+    m_EntryCount = (size_t)header->EntryCount;
+    return true;
+}
+
+const AssetArchiveEntry* AssetArchive::Find(const Pipeline::HashId& assetId) const
+{
+    const AssetArchiveEntry* end = m_Entries + m_EntryCount;
+    const AssetArchiveEntry* found = std::lower_bound(m_Entries, end, assetId, [](const AssetArchiveEntry& entry, const Pipeline::HashId& id)
+    {
+        return entry.AssetId < id;
+    });
+
+    if (found == end || found->AssetId != assetId)
+        return nullptr;
+
+    return found;
+}
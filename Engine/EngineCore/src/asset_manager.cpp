@@ -1,52 +1,140 @@
 #include "EngineCore/Runtime/asset_manager.h"
 #include "EngineCore/AssetManagement/asset_loading_context.h"
 #include "EngineCore/AssetManagement/async_io_event.h"
+#include "EngineCore/AssetManagement/compressed_asset.h"
+#include "EngineCore/AssetManagement/entity_file.h"
+#include "EngineCore/Configuration/configuration_provider.h"
 #include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Pipeline/module_assembly.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/index_queue.h"
 #include "EngineCore/Runtime/module_manager.h"
 #include "EngineCore/Runtime/service_table.h"
+#include "EngineCore/Runtime/task_manager.h"
 #include "EngineCore/Runtime/transient_allocator.h"
 #include "EngineUtils/Memory/memstream_lite.h"
 #include "EngineCore/Runtime/world_state.h"
 #include "EngineUtils/String/hex_strings.h"
-#include "SDL3/SDL_asyncio.h"
 #include "SDL3/SDL_error.h"
+#include "SDL3/SDL_iostream.h"
 #include "SDL3/SDL_storage.h"
+#include "SDL3/SDL_timer.h"
 #include <md5.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
 
 using namespace Engine::Core::Runtime;
 using namespace Engine::Utils::Memory;
 
+// registering a transient group with the IO backend costs two syscalls, groups with fewer reads than this into
+// their own buffer are read the regular way
+static constexpr int MinRegisteredGroupReads = 8;
 
-size_t AssetManager::GetAssetSize(Engine::Core::Pipeline::HashId assetId)
+bool AssetManager::QueryAssetSize(SDL_Storage* storage, Pipeline::HashId assetId, size_t* outSize, size_t* outCompressedSize)
 {
     char nameBuffer[] = "2D87CCD68F05994578FAFA7AF7750AB4.bse_asset";
     Utils::String::BinaryToHex(sizeof(assetId), assetId.Hash.data(), nameBuffer);
 
+    *outSize = 0;
+    *outCompressedSize = 0;
     size_t fileSize = 0;
-    if (!SDL_GetStorageFileSize(m_StorageFolder, nameBuffer, &fileSize))
+    if (!SDL_GetStorageFileSize(storage, nameBuffer, &fileSize))
+        return false;
+
+    // compressed files are recognized by their header, the size the asset loads into is stored in there
+    AssetManagement::CompressedAssetHeader header;
+    SDL_IOStream* file = fileSize >= sizeof(header) ? SDL_IOFromFile(nameBuffer, "rb") : nullptr;
+    if (file != nullptr)
     {
-        m_Logger.Error("Failed to get file size for {}, detail: {}", nameBuffer, SDL_GetError());
+        size_t headerSize = SDL_ReadIO(file, &header, sizeof(header));
+        SDL_CloseIO(file);
+
+        // only the header is read, the block table is checked against the real size when the data is in
+        if (headerSize == sizeof(header) && header.MagicWord == AssetManagement::CompressedAssetMagicWord)
+        {
+            *outSize = (size_t)header.UncompressedSize;
+            *outCompressedSize = fileSize;
+            return true;
+        }
+    }
+
+    *outSize = fileSize;
+    return true;
+}
+
+size_t AssetManager::GetAssetSize(Engine::Core::Pipeline::HashId assetId, size_t* outCompressedSize)
+{
+    size_t fileSize = 0;
+    if (!QueryAssetSize(m_StorageFolder, assetId, &fileSize, outCompressedSize))
+    {
+        m_Logger.Error("Failed to get file size for asset {}, detail: {}", assetId, SDL_GetError());
     }
     return fileSize;
 }
 
+CallbackResult AssetManager::ResolveAssetSizes(void* state)
+{
+    auto batch = static_cast<AssetSizeBatch*>(state);
+    for (AssetManagement::AssetLoadingContext& context : batch->Contexts)
+    {
+        // failures are reported on the main thread, a zero size marks them
+        if (context.SourceSize == 0)
+            QueryAssetSize(batch->Storage, context.AssetId, &context.SourceSize, &context.CompressedSize);
+    }
 
-void AssetManager::QueueEntity(Pipeline::HashId entityId)
+    batch->Completed.store(true, std::memory_order_release);
+    return CallbackSuccess();
+}
+
+void AssetManager::DrainAssetSizeBatches()
 {
+    // batches finish in any order but entities are contextualized in the order they were loaded
+    size_t drained = 0;
+    while (drained < m_AssetSizeBatches.size() && m_AssetSizeBatches[drained]->Completed.load(std::memory_order_acquire))
+    {
+        for (const AssetManagement::AssetLoadingContext& context : m_AssetSizeBatches[drained]->Contexts)
+        {
+            // the entity may have been replaced or canceled while the sizes were looked up
+            if (!IsAssetReferenced(context))
+            {
+                UntrackPendingAsset(context);
+                continue;
+            }
+
+            if (context.SourceSize == 0)
+                m_Logger.Error("Failed to get file size for asset {}, it will be loaded empty.", context.AssetId);
+            m_ContextualizeQueues[(size_t)context.Priority].push_back(context);
+        }
+        drained++;
+    }
+
+    m_AssetSizeBatches.erase(m_AssetSizeBatches.begin(), m_AssetSizeBatches.begin() + drained);
+}
+
+void AssetManager::QueueEntity(Pipeline::HashId entityId, AssetManagement::LoadPriority priority)
+{
+    // only the last entity file read makes up the world, reads of earlier ones are wasted
+    for (const std::unique_ptr<AssetManagement::AsyncEntityEvent>& pendingEntity : m_EntityLoadingQueue)
+    {
+        if (!pendingEntity->IsCanceled())
+        {
+            m_Logger.Information("Entity {} superseded by {}.", pendingEntity->GetId(), entityId);
+            pendingEntity->Cancel();
+        }
+    }
+
     char nameBuffer[] = "2D87CCD68F05994578FAFA7AF7750AB4.bse_entity";
     Utils::String::BinaryToHex(sizeof(entityId), entityId.Hash.data(), nameBuffer);
-    SDL_AsyncIO *ioObject = SDL_AsyncIOFromFile(nameBuffer, "r");
 
-    if (ioObject == nullptr)
+    size_t size = 0;
+    if (m_StorageFolder == nullptr || !SDL_GetStorageFileSize(m_StorageFolder, nameBuffer, &size))
     {
         m_Logger.Error("Entity {} can't be opened for read, details: {}", entityId, SDL_GetError());
         return;
     }
 
-    size_t size = SDL_GetAsyncIOSize(ioObject);
     auto bufferId = m_Services->TransientAllocator->CreateBufferGroup(size, 1);
     void* buffer = m_Services->TransientAllocator->GetBuffer(bufferId);
 
@@ -56,17 +144,21 @@ void AssetManager::QueueEntity(Pipeline::HashId entityId)
         return;
     }
 
-    m_EntityLoadingQueue.push_back(AssetManagement::AsyncEntityEvent(bufferId, size, entityId));
+    m_EntityLoadingQueue.push_back(std::make_unique<AssetManagement::AsyncEntityEvent>(bufferId, size, entityId, priority));
     
-    if (!SDL_ReadAsyncIO(ioObject, buffer, 0, size, m_AsyncQueue, &*(m_EntityLoadingQueue.end() - 1)))
+    if (!m_IoBackend->QueueRead(nameBuffer, buffer, 0, size, m_EntityLoadingQueue.back().get()))
     {
         m_Logger.Error("Entity {} can't be loaded, details: {}", entityId, SDL_GetError());
+        m_EntityLoadingQueue.pop_back();
+        return;
     }
 
+    // the world is waiting for this one, it doesn't wait for the next poll
+    m_IoBackend->Submit();
     m_Logger.Information("Entity {} queued for loading.", entityId);
 }
 
-void AssetManager::QueueAsset(Engine::Core::Pipeline::HashId module, Pipeline::HashId type, Pipeline::HashId assetId)
+void AssetManager::QueueAsset(Engine::Core::Pipeline::HashId module, Pipeline::HashId type, Pipeline::HashId assetId, AssetManagement::LoadPriority priority)
 {
     if (m_StorageFolder == nullptr)
     {
@@ -74,7 +166,8 @@ void AssetManager::QueueAsset(Engine::Core::Pipeline::HashId module, Pipeline::H
         return;
     }
 
-    size_t fileSize = GetAssetSize(assetId);
+    size_t compressedSize = 0;
+    size_t fileSize = GetAssetSize(assetId, &compressedSize);
 
     if (fileSize == 0)
     {
@@ -82,19 +175,149 @@ void AssetManager::QueueAsset(Engine::Core::Pipeline::HashId module, Pipeline::H
         return;
     }
 
-    m_AssetReloadQueue.push_back({
+    AssetManagement::AssetLoadingContext context {
         true,
         fileSize,
         { module, type },
         assetId
-    });
+    };
+    context.Buffer.Type = AssetManagement::LoadBufferType::Invalid;
+    context.CompressedSize = compressedSize;
+    context.Priority = priority;
+    m_ContextualizeQueues[(size_t)priority].push_back(context);
+    TrackPendingAsset({ context.AssetGroupId, assetId });
+}
+
+bool AssetManager::CopyMappedAsset(AssetManagement::AsyncAssetEvent* destination)
+{
+    AssetManagement::AssetLoadingContext* context = destination->GetContext();
+
+    void* dest = nullptr;
+    switch (context->Buffer.Type)
+    {
+    case AssetManagement::LoadBufferType::TransientBuffer:
+        dest = m_Services->TransientAllocator->GetBuffer(context->Buffer.Location.TransientBufferId);
+        break;
+    case AssetManagement::LoadBufferType::ModuleBuffer:
+        dest = context->Buffer.Location.ModuleBuffer;
+        break;
+    default:
+        break;
+    }
+
+    if (dest == nullptr)
+    {
+        m_Logger.Error("Error loading asset {}:{}: no destination buffer for packed asset.", destination->GetDefinition()->Name.DisplayName, context->AssetId);
+        destination->MakeBroken();
+        destination->MakeAvailable();
+        return false;
+    }
+
+    memcpy(dest, context->MappedSource, context->SourceSize);
+    OnAssetLoaded(destination);
+    return true;
+}
+
+void AssetManager::OnAssetLoaded(AssetManagement::AsyncAssetEvent* asset)
+{
+    AssetManagement::AssetLoadingContext* context = asset->GetContext();
+    bool compressed = context->CompressedSize > 0;
+    if (!compressed && asset->GetDefinition()->Process == nullptr)
+    {
+        asset->MakeAvailable();
+        return;
+    }
+
+    // the transient allocator isn't safe to use from workers, resolve the buffer here
+    void* loadedData = context->Buffer.Type == AssetManagement::LoadBufferType::TransientBuffer
+        ? m_Services->TransientAllocator->GetBuffer(context->Buffer.Location.TransientBufferId)
+        : AssetManagement::GetModuleVisibleBuffer(context);
+    asset->PrepareProcess(loadedData, m_Services);
+
+    // compressed assets are decompressed on workers first, process runs right after on the same task
+    Task task;
+    task.Type = TaskType::GenericTask;
+    task.Payload.GenericTask = { compressed ? DecompressAsset : ProcessAsset, asset };
+    m_Services->TaskManager->ScheduleWork(task, &m_ProcessTasks);
+}
+
+CallbackResult AssetManager::DecompressAsset(void* state)
+{
+    auto asset = static_cast<AssetManagement::AsyncAssetEvent*>(state);
+    AssetManagement::AssetLoadingContext* context = asset->GetContext();
+
+    bool decompressed = asset->GetLoadedData() != nullptr && AssetManagement::DecompressAsset(
+        asset->GetServices()->TaskManager,
+        asset->GetCompressedData(),
+        context->CompressedSize,
+        asset->GetLoadedData(),
+        context->SourceSize);
+    asset->ReleaseCompressedData();
+
+    // the index reports broken assets, there's no logger on this side
+    if (!decompressed)
+    {
+        asset->MakeBroken();
+        asset->MakeAvailable();
+        return CallbackSuccess();
+    }
+
+    if (asset->GetDefinition()->Process == nullptr)
+    {
+        asset->MakeAvailable();
+        return CallbackSuccess();
+    }
+
+    return ProcessAsset(state);
+}
+
+CallbackResult AssetManager::ProcessAsset(void* state)
+{
+    auto asset = static_cast<AssetManagement::AsyncAssetEvent*>(state);
+    asset->SetProcessResult(asset->GetDefinition()->Process(
+        asset->GetServices(),
+        asset->GetModuleState(),
+        asset->GetContext(),
+        asset->GetLoadedData()));
+
+    // the error goes to the index queue with the asset, the task itself always succeeds
+    asset->MakeAvailable();
+    return CallbackSuccess();
 }
 
 bool AssetManager::LoadAssetFileAsync(AssetManagement::AsyncAssetEvent* destination)
 {
+    // packed assets are already in memory, copying them out doesn't need any IO
+    if (destination->GetContext()->MappedSource != nullptr)
+        return CopyMappedAsset(destination);
+
+    // same for packed compressed ones, they're decompressed straight out of the archive
+    if (destination->GetContext()->CompressedSource != nullptr)
+    {
+        destination->SetCompressedData(destination->GetContext()->CompressedSource);
+        OnAssetLoaded(destination);
+        return true;
+    }
+
     char nameBuffer[] = "2D87CCD68F05994578FAFA7AF7750AB4.bse_asset";
     Utils::String::BinaryToHex(sizeof(destination->GetContext()->AssetId), destination->GetContext()->AssetId.Hash.data(), nameBuffer);
-    SDL_AsyncIO *ioObject = SDL_AsyncIOFromFile(nameBuffer, "r");
+
+    // compressed files are read into a staging buffer, the destination only ever sees them decompressed
+    AssetManagement::LoadBufferType bufferType = destination->GetContext()->Buffer.Type;
+    size_t compressedSize = destination->GetContext()->CompressedSize;
+    if (compressedSize > 0 && (bufferType == AssetManagement::LoadBufferType::TransientBuffer || bufferType == AssetManagement::LoadBufferType::ModuleBuffer))
+    {
+        void* staging = destination->AllocateCompressedStaging(compressedSize);
+        if (staging == nullptr || !m_IoBackend->QueueRead(nameBuffer, staging, 0, compressedSize, destination))
+        {
+            m_Logger.Error("Error loading compressed asset {}:{}: {}", destination->GetDefinition()->Name.DisplayName, destination->GetContext()->AssetId, SDL_GetError());
+            destination->ReleaseCompressedData();
+            return false;
+        }
+
+        m_ReadsInFlight++;
+        return true;
+    }
 
     switch (destination->GetContext()->Buffer.Type)
     {
@@ -107,23 +330,26 @@ bool AssetManager::LoadAssetFileAsync(AssetManagement::AsyncAssetEvent* destinat
                 return false;
             }
 
-            if (!SDL_ReadAsyncIO(ioObject, dest, 0, destination->GetContext()->SourceSize, m_AsyncQueue, destination))
+            if (!m_IoBackend->QueueRead(nameBuffer, dest, 0, destination->GetContext()->SourceSize, destination))
             {
                 m_Logger.Error("Error loading asset {}:{}: {}", destination->GetDefinition()->Name.DisplayName, destination->GetContext()->AssetId, SDL_GetError());
                 return false;
             }
 
+            m_ReadsInFlight++;
             return true;
         }
     case AssetManagement::LoadBufferType::ModuleBuffer:
         {
-            if (!SDL_ReadAsyncIO(ioObject, destination->GetContext()->Buffer.Location.ModuleBuffer, 0, destination->GetContext()->SourceSize, m_AsyncQueue, destination))
+            if (!m_IoBackend->QueueRead(nameBuffer, destination->GetContext()->Buffer.Location.ModuleBuffer, 0, destination->GetContext()->SourceSize, destination))
             {
                 m_Logger.Error("Error loading asset {}: {}", destination->GetContext()->AssetId, SDL_GetError());
                 return false;
             }
+            m_ReadsInFlight++;
             return true;
         }
+    case AssetManagement::LoadBufferType::MappedBuffer:
     case AssetManagement::LoadBufferType::Invalid:
         m_Logger.Warning("Requested async asset loading on invalid loading context for asset {}.", destination->GetContext()->AssetId);
         return false;
@@ -150,72 +376,241 @@ static bool CheckMagicWord(unsigned int target, MemStreamLite& stream)
 }
 
 
-CallbackResult AssetManager::ProcessIndexQueue(IndexQueue*& queue)
+void AssetManager::TrackPendingAsset(const AssetKey& key)
 {
-    if (queue == nullptr)
-        return CallbackSuccess();
-
-    // try to flush elements
-    CallbackResult result = queue->Flush();
-    if (result.has_value())
-        return result;
+    m_PendingAssets[key.AssetId]++;
+    m_AssetRecords[key].LoadsInFlight++;
+}
 
-    // update the head
-    IndexQueue* newHead = queue;
-    while (newHead != nullptr && newHead->IsCompleted())
+void AssetManager::UntrackPendingAsset(const AssetKey& key)
+{
+    auto pending = m_PendingAssets.find(key.AssetId);
+    if (pending != m_PendingAssets.end())
     {
-        m_Services->TransientAllocator->Return(newHead->GetBufferId());
-        newHead = newHead->GetNext();
+        pending->second--;
+        if (pending->second == 0)
+            m_PendingAssets.erase(pending);
     }
 
-    queue = newHead;
-    return CallbackSuccess();
+    auto record = m_AssetRecords.find(key);
+    if (record == m_AssetRecords.end() || record->second.LoadsInFlight == 0)
+        return;
+
+    // a load that was dropped or failed leaves nothing behind, the next entity asking for the asset tries again
+    record->second.LoadsInFlight--;
+    if (record->second.LoadsInFlight == 0 && record->second.ReferenceCount == 0 && !record->second.Resident)
+        m_AssetRecords.erase(record);
 }
 
+void AssetManager::UntrackPendingAsset(const AssetManagement::AssetLoadingContext& context)
+{
+    UntrackPendingAsset({ context.AssetGroupId, context.AssetId });
+}
 
-CallbackResult AssetManager::PollEvents()
+bool AssetManager::HasPendingDependencies(const AssetManagement::AssetLoadingContext* context) const
 {
-    // receive async IO events
-    SDL_AsyncIOOutcome lastResult;
-    while (SDL_GetAsyncIOResult(m_AsyncQueue, &lastResult))
+    for (size_t i = 0; i < context->DependencyCount; i++)
     {
-        // we'll use null userdata for events not worth tracking
-        if (lastResult.userdata == nullptr)
-            continue;
+        if (context->Dependencies[i] != context->AssetId && m_PendingAssets.find(context->Dependencies[i]) != m_PendingAssets.end())
+            return true;
+    }
+    return false;
+}
+
+IndexQueue* AssetManager::CreateIndexQueue(size_t eventCount)
+{
+    size_t indexQueueBufferSize = sizeof(IndexQueue) + eventCount * sizeof(AssetManagement::AsyncAssetEvent);
+    TransientBufferId indexQueueBufferId = m_Services->TransientAllocator->CreateBufferGroup(indexQueueBufferSize, 1);
 
-        // close file
-        SDL_CloseAsyncIO(lastResult.asyncio, false, m_AsyncQueue, nullptr);
+    AssetManagement::AsyncAssetEvent* events =
+        (AssetManagement::AsyncAssetEvent*)((char*)m_Services->TransientAllocator->GetBuffer(indexQueueBufferId) + sizeof(IndexQueue));
 
-        for (int i = 0; i < 1000000; i++)
+    IndexQueue* newIndexQueue = new (m_Services->TransientAllocator->GetBuffer(indexQueueBufferId)) IndexQueue(indexQueueBufferId, events, eventCount);
+    m_IndexQueues.push_back(newIndexQueue);
+    return newIndexQueue;
+}
+
+CallbackResult AssetManager::IndexReadyAssets(Uint64 deadline)
+{
+    // indexing one asset can unblock others further up the list, keep going over it until nothing moves
+    bool indexedAny = true;
+    bool firstIndex = true;
+    bool outOfTime = false;
+    CallbackResult failure = CallbackSuccess();
+    while (indexedAny && !outOfTime && !failure.has_value() && !m_IndexWaitList.empty())
+    {
+        indexedAny = false;
+
+        // contexts of an asset that is queued more than once (a reload on top of a load) are indexed in queue order
+        std::unordered_set<Pipeline::HashId> heldBack;
+
+        size_t kept = 0;
+        for (size_t i = 0; i < m_IndexWaitList.size(); i++)
         {
-            auto V = i + 566;
+            IndexWaiter waiter = m_IndexWaitList[i];
+            AssetManagement::AsyncAssetEvent* currentEvent = waiter.Event;
+            AssetManagement::AssetLoadingContext* context = currentEvent->GetContext();
+
+            // everything left over stays in order for the next poll, the list is compacted even when indexing failed
+            outOfTime = outOfTime || (!firstIndex && SDL_GetTicksNS() >= deadline);
+            if (outOfTime || failure.has_value())
+            {
+                m_IndexWaitList[kept++] = waiter;
+                continue;
+            }
+
+            if (heldBack.count(context->AssetId) > 0 || !currentEvent->IsAvailable() || HasPendingDependencies(context))
+            {
+                heldBack.insert(context->AssetId);
+                m_IndexWaitList[kept++] = waiter;
+                continue;
+            }
+
+            // a failed process stage is as fatal as a failed index
+            CallbackResult result = currentEvent->GetProcessResult();
+            if (currentEvent->IsBroken())
+            {
+                m_Logger.Information("Asset {} became unindexable and is skipped.", context->AssetId);
+            }
+            else if (!result.has_value() && context->Buffer.Type != AssetManagement::LoadBufferType::Invalid)
+            {
+                // contexts rejected by the contextualizer (usually because the asset is loaded already) have nothing to index
+                m_Logger.Information("Indexing asset {} {}.", currentEvent->GetDefinition()->Name.DisplayName, context->AssetId);
+                result = currentEvent->GetDefinition()->Index(m_Services, currentEvent->GetModuleState(), context);
+                if (!result.has_value())
+                    OnAssetIndexed(context);
+                firstIndex = false;
+            }
+
+            // skipped and failed assets too, their share of the group still counts towards the group's lifetime
+            if (context->Buffer.Type == AssetManagement::LoadBufferType::TransientBuffer)
+                m_Services->TransientAllocator->Return(context->Buffer.Location.TransientBufferId);
+
+            // a failed asset is finished all the same, so it isn't indexed again on the next poll
+            if (result.has_value())
+                failure = result;
+
+            UntrackPendingAsset(*context);
+            waiter.Queue->MarkFinished();
+            indexedAny = true;
+        }
+        m_IndexWaitList.resize(kept);
+    }
+
+    // batches that have been fully indexed give their buffer back
+    size_t keptQueues = 0;
+    for (IndexQueue* queue : m_IndexQueues)
+    {
+        if (queue->IsCompleted())
+        {
+            queue->DestroyEvents();
+            m_Services->TransientAllocator->Return(queue->GetBufferId());
         }
+        else
+            m_IndexQueues[keptQueues++] = queue;
+    }
+    m_IndexQueues.resize(keptQueues);
+
+    if (failure.has_value())
+        return failure;
 
-        auto resource = static_cast<AssetManagement::AsyncIoEvent*>(lastResult.userdata);
+    // a dependency cycle can only be broken by indexing one of its members without the others; that's the case when
+    // every waiting asset is loaded, yet none of them can go, and nothing else is on its way
+    bool nothingElseQueued = !HasQueuedContexts() && m_AssetSizeBatches.empty();
+    if (!m_IndexWaitList.empty() && nothingElseQueued && SDL_GetTicksNS() < deadline)
+    {
+        bool allLoaded = true;
+        for (const IndexWaiter& waiter : m_IndexWaitList)
+        {
+            allLoaded = allLoaded && waiter.Event->IsAvailable();
+        }
+
+        if (allLoaded)
+        {
+            AssetManagement::AssetLoadingContext* context = m_IndexWaitList[0].Event->GetContext();
+            m_Logger.Warning("Asset {} is part of a dependency cycle, its dependencies are ignored.", context->AssetId);
+            context->DependencyCount = 0;
+        }
+    }
+
+    return CallbackSuccess();
+}
+
+
+CallbackResult AssetManager::PollEvents()
+{
+    // every phase does at least one unit of work per frame, after that each one stops as soon as the budget ran out
+    Uint64 deadline = m_Configs->AssetPollBudgetMicroseconds > 0
+        ? SDL_GetTicksNS() + (Uint64)m_Configs->AssetPollBudgetMicroseconds * 1000
+        : UINT64_MAX;
+
+    // receive async IO events, anything not taken out of the queue stays there until the next frame
+    AssetManagement::AssetIoCompletion lastResult;
+    bool firstCompletion = true;
+    while ((firstCompletion || SDL_GetTicksNS() < deadline) && m_IoBackend->GetCompletion(&lastResult))
+    {
+        firstCompletion = false;
+
+        auto resource = static_cast<AssetManagement::AsyncIoEvent*>(lastResult.UserData);
         switch (resource->GetType())
         {
         case AssetManagement::EventType::Entity:
             {
                 auto entityEvent = static_cast <AssetManagement::AsyncEntityEvent*>(resource);
 
-                switch (lastResult.result)
+                switch (lastResult.Status)
                 {
-                case SDL_ASYNCIO_COMPLETE:
+                case AssetManagement::AssetIoStatus::Complete:
                     {
-                        m_Logger.Information("Entity ready for processing: {}", entityEvent->GetId());
                         TransientBufferReturnHelper helper = { entityEvent->GetBuffer(), m_Services->TransientAllocator };
+                        if (entityEvent->IsCanceled())
+                        {
+                            m_Logger.Information("Entity {} was canceled while it was read, dropped.", entityEvent->GetId());
+                            break;
+                        }
 
-                        MemStreamLite stream { m_Services->TransientAllocator->GetBuffer(helper.Id) };
+                        m_Logger.Information("Entity ready for processing: {}", entityEvent->GetId());
+
+                        // compressed entity files use the asset format, they're small enough to be decompressed right here
+                        void* entityData = m_Services->TransientAllocator->GetBuffer(helper.Id);
+                        std::vector<unsigned char> decompressedEntity;
+                        AssetManagement::CompressedAssetHeader entityHeader;
+                        if (AssetManagement::ReadCompressedAssetHeader(entityData, entityEvent->GetLegnth(), &entityHeader))
+                        {
+                            decompressedEntity.resize((size_t)entityHeader.UncompressedSize);
+                            if (!AssetManagement::DecompressAsset(m_Services->TaskManager, entityData, entityEvent->GetLegnth(), decompressedEntity.data(), decompressedEntity.size()))
+                            {
+                                m_Logger.Error("Entity {} is compressed but corrupted (loading skipped).", entityEvent->GetId());
+                                break;
+                            }
+                            entityData = decompressedEntity.data();
+                        }
+
+                        MemStreamLite stream { entityData };
                         size_t readCount = 0;
 
                         // read the asset section
-                        if (!CheckMagicWord(0xCCBBFFF1, stream))
+                        unsigned int assetSectionWord = stream.Read<unsigned int>();
+                        if (assetSectionWord == AssetManagement::LegacyEntityAssetSectionMagicWord)
+                        {
+                            m_Logger.Error("Entity {} was built without asset sizes, rebuild it with the current entity builder (loading skipped).", entityEvent->GetId());
+                            break;
+                        }
+                        bool hasCompressedSizes = assetSectionWord == AssetManagement::EntityAssetSectionMagicWord;
+                        if (!hasCompressedSizes && assetSectionWord != AssetManagement::SizedEntityAssetSectionMagicWord)
                         {
                             m_Logger.Error("Entity {} magic word for asset section mismatch (loading skipped).", entityEvent->GetId());
                             break;
                         }
 
-                        // queue asset groups for contextualization
+                        // queue asset groups for contextualization; entities behind a pending size batch have to wait
+                        // for it as well, otherwise their assets could be indexed before the ones they depend on
+                        std::vector<AssetManagement::AssetLoadingContext>& contextualizeQueue = m_ContextualizeQueues[(size_t)entityEvent->GetPriority()];
+                        size_t contextualizeQueueStart = contextualizeQueue.size();
+                        std::unique_ptr<AssetSizeBatch> sizeBatch = m_AssetSizeBatches.empty() ? nullptr : std::make_unique<AssetSizeBatch>();
+                        size_t unknownSizeCount = 0;
+                        size_t sharedAssetCount = 0;
+                        std::vector<AssetKey> entityAssets;
                         int assetGroupCount = stream.Read<int>();
                         for (int assetGroupIndex = 0; assetGroupIndex < assetGroupCount; assetGroupIndex ++)
                         {
@@ -223,26 +618,106 @@ CallbackResult AssetManager::PollEvents()
                             int groupSize = stream.Read<int>();
 
                             // note here asset groups are always continuous in the contextualization queue
-                            m_ContextualizeQueue.reserve(m_ContextualizeQueue.size() + groupSize);
+                            contextualizeQueue.reserve(contextualizeQueue.size() + groupSize);
                             for (int assetIndex = 0; assetIndex < groupSize; assetIndex ++)
                             {
                                 Pipeline::HashId nextAssetId = stream.Read<Pipeline::HashId>();
-                                // stream.Read<size_t>();
-                                m_ContextualizeQueue.push_back(AssetManagement::AssetLoadingContext{
+                                size_t assetSize = stream.Read<size_t>();
+                                size_t compressedSize = hasCompressedSizes ? stream.Read<size_t>() : 0;
+
+                                AssetKey key { assetGroupId, nextAssetId };
+                                AssetRecord& record = AcquireAsset(key);
+                                entityAssets.push_back(key);
+
+                                // one copy serves every entity that lists the asset, a load on its way is joined
+                                // instead of started again
+                                if (record.Resident || record.LoadsInFlight > 0)
+                                {
+                                    sharedAssetCount++;
+                                    continue;
+                                }
+                                TrackPendingAsset(key);
+
+                                // packed assets skip the file system entirely
+                                const AssetManagement::AssetArchiveEntry* packedAsset = m_Archive.Find(nextAssetId);
+                                void* packedData = packedAsset != nullptr ? m_Archive.GetData(packedAsset) : nullptr;
+                                AssetManagement::CompressedAssetHeader compressedHeader;
+                                bool packedCompressed = packedAsset != nullptr && AssetManagement::ReadCompressedAssetHeader(packedData, (size_t)packedAsset->Size, &compressedHeader);
+                                if (packedCompressed)
+                                    assetSize = (size_t)compressedHeader.UncompressedSize;
+                                else if (packedAsset != nullptr)
+                                    assetSize = (size_t)packedAsset->Size;
+                                else if (assetSize == 0)
+                                    unknownSizeCount++;
+
+                                contextualizeQueue.push_back(AssetManagement::AssetLoadingContext{
                                     false,
-                                    GetAssetSize(nextAssetId),
+                                    assetSize,
                                     assetGroupId,
                                     nextAssetId,
                                     {
                                         {},
                                         AssetManagement::LoadBufferType::Invalid
-                                    }
+                                    },
+                                    nullptr,
+                                    packedCompressed ? nullptr : packedData
                                 });
+                                if (packedCompressed)
+                                {
+                                    contextualizeQueue.back().CompressedSize = (size_t)packedAsset->Size;
+                                    contextualizeQueue.back().CompressedSource = packedData;
+                                }
+                                else if (packedAsset == nullptr)
+                                {
+                                    // loose compressed files are read into a staging buffer of this size
+                                    contextualizeQueue.back().CompressedSize = compressedSize;
+                                }
+                                contextualizeQueue.back().Priority = entityEvent->GetPriority();
+                            }
+                        }
+
+                        // a reloaded entity file takes its new references before it drops the old ones, so the
+                        // assets it still uses never become unreferenced in between
+                        std::vector<AssetKey> previousEntityAssets = std::move(m_EntityAssetReferences[entityEvent->GetId()]);
+                        m_EntityAssetReferences[entityEvent->GetId()] = std::move(entityAssets);
+                        for (const AssetKey& previousAsset : previousEntityAssets)
+                        {
+                            ReleaseAsset(previousAsset);
+                        }
+
+                        if (sharedAssetCount > 0)
+                            m_Logger.Verbose("Entity {} shares {} asset(s) that are loaded or on their way already.", entityEvent->GetId(), sharedAssetCount);
+
+                        // sizes missing from the entity file are looked up off the main thread, all at once
+                        if (unknownSizeCount > 0 || sizeBatch != nullptr)
+                        {
+                            size_t entityAssetCount = contextualizeQueue.size() - contextualizeQueueStart;
+                            if (sizeBatch == nullptr)
+                                sizeBatch = std::make_unique<AssetSizeBatch>();
+
+                            sizeBatch->Storage = m_StorageFolder;
+                            sizeBatch->Contexts.assign(contextualizeQueue.begin() + contextualizeQueueStart, contextualizeQueue.end());
+                            contextualizeQueue.resize(contextualizeQueueStart);
+
+                            if (unknownSizeCount > 0)
+                            {
+                                m_Logger.Information("Entity {} lacks the size of {} asset(s), looking them up on a worker.", entityEvent->GetId(), unknownSizeCount);
+                                Task task;
+                                task.Type = TaskType::GenericTask;
+                                task.Payload.GenericTask = { ResolveAssetSizes, sizeBatch.get() };
+                                m_Services->TaskManager->ScheduleWork(task, &m_SizeTasks);
+                            }
+                            else
+                            {
+                                sizeBatch->Completed.store(true, std::memory_order_release);
                             }
+
+                            m_AssetSizeBatches.push_back(std::move(sizeBatch));
+                            m_Logger.Verbose("Entity {} queued {} asset(s) behind a size lookup.", entityEvent->GetId(), entityAssetCount);
                         }
 
                         // read the entities
-                        if (!CheckMagicWord(0xCCBBFFF2, stream))
+                        if (!CheckMagicWord(AssetManagement::EntitySectionMagicWord, stream))
                         {
                             m_Logger.Error("Entity {} magic word for entity section mismatch (loading skipped).", entityEvent->GetId());
                             break;
@@ -253,8 +728,23 @@ CallbackResult AssetManager::PollEvents()
                             break;
                         }
 
+                        // the world only holds one entity file at a time, whatever the replaced ones referenced is
+                        // released (but stays loaded until the memory budget needs the space)
+                        std::vector<Pipeline::HashId> replacedEntities;
+                        for (const auto& entityReferences : m_EntityAssetReferences)
+                        {
+                            if (entityReferences.first != entityEvent->GetId())
+                                replacedEntities.push_back(entityReferences.first);
+                        }
+                        for (Pipeline::HashId replacedEntity : replacedEntities)
+                        {
+                            ReleaseEntityAssets(replacedEntity);
+                        }
+                        if (!replacedEntities.empty())
+                            DropUnreferencedContexts();
+
                         // read the components
-                        if (!CheckMagicWord(0xCCBBFFF3, stream))
+                        if (!CheckMagicWord(AssetManagement::EntityComponentSectionMagicWord, stream))
                         {
                             m_Logger.Error("Entity {} magic word for component section mismatch (loading skipped).", entityEvent->GetId());
                             break;
@@ -278,40 +768,51 @@ CallbackResult AssetManager::PollEvents()
                         break;
                     }
                     break;
-                case SDL_ASYNCIO_FAILURE:
+                case AssetManagement::AssetIoStatus::Failure:
                     m_Logger.Warning("Entity {} loading failed, detail: {}.", 
                         entityEvent->GetId(),
-                        SDL_GetError()
+                        lastResult.ErrorDetail
                     );
                     break;
-                case SDL_ASYNCIO_CANCELED:
+                case AssetManagement::AssetIoStatus::Canceled:
                     m_Logger.Warning("Entity {} loading canceled by operating system.", 
                         entityEvent->GetId()
                     );
                     break;
                 }
+
+                // the IO backend is done with the event
+                m_EntityLoadingQueue.erase(std::find_if(m_EntityLoadingQueue.begin(), m_EntityLoadingQueue.end(), [entityEvent](const std::unique_ptr<AssetManagement::AsyncEntityEvent>& candidate)
+                {
+                    return candidate.get() == entityEvent;
+                }));
             }
             break;
         case AssetManagement::EventType::Asset:
             {
                 auto asset = static_cast<AssetManagement::AsyncAssetEvent*>(resource);
-                switch (lastResult.result)
+                m_ReadsInFlight--;
+                switch (lastResult.Status)
                 {
-                case SDL_ASYNCIO_COMPLETE:
-                    asset->MakeAvailable();
+                case AssetManagement::AssetIoStatus::Complete:
+                    OnAssetLoaded(asset);
                     m_Logger.Information("Asset {}:{} loaded and made ready for indexing.", 
                         asset->GetDefinition()->Name.DisplayName, 
                         asset->GetContext()->AssetId);
                     break;
-                case SDL_ASYNCIO_FAILURE:
+                case AssetManagement::AssetIoStatus::Failure:
+                    asset->ReleaseCompressedData();
                     asset->MakeBroken();
+                    asset->MakeAvailable();
                     m_Logger.Warning("Asset {}:{} loading failed, detail: {}.", 
                         asset->GetDefinition()->Name.DisplayName, 
                         asset->GetContext()->AssetId,
-                        SDL_GetError());
+                        lastResult.ErrorDetail);
                     break;
-                case SDL_ASYNCIO_CANCELED:
+                case AssetManagement::AssetIoStatus::Canceled:
+                    asset->ReleaseCompressedData();
                     asset->MakeBroken();
+                    asset->MakeAvailable();
                     m_Logger.Warning("Asset {}:{} loading canceled.", 
                         asset->GetDefinition()->Name.DisplayName, 
                         asset->GetContext()->AssetId);
@@ -322,129 +823,46 @@ CallbackResult AssetManager::PollEvents()
         }
     }
 
-    // process all index queues
-    if (m_DependencyAgnosticIndexQueue != nullptr)
-    {
-        CallbackResult result = ProcessIndexQueue(m_DependencyAgnosticIndexQueue);
-        if (result.has_value())
-            return result;
-    }
-    for (auto& moduleLocalQueue : m_IndexQueues)
+    // entities whose asset sizes are resolved now join the contextualization queue
+    if (!m_AssetSizeBatches.empty())
+        DrainAssetSizeBatches();
+
+    // index everything that is loaded and whose dependencies are in
+    if (!m_IndexQueues.empty())
     {
-        CallbackResult result = ProcessIndexQueue(moduleLocalQueue.second);
+        CallbackResult result = IndexReadyAssets(deadline);
         if (result.has_value())
             return result;
     }
 
-    // process asset reload requests
-    if (!m_AssetReloadQueue.empty())
+    // process contextualized assets, most urgent first; reads are capped so background work can't starve a critical request
+    bool contextualizeStopped = false;
+    for (size_t priority = 0; priority < AssetManagement::LoadPriorityCount && !contextualizeStopped; priority++)
     {
-        size_t transientBufferBudget = 0;
-        size_t transientBufferCount = 0;
-
-        // allocate a new index buffer for all of these: they are processed only in the same order to themselves and all dependency rules are disregarded
-        size_t indexQueueBufferSize = sizeof(IndexQueue) + m_AssetReloadQueue.size() * sizeof(AssetManagement::AsyncAssetEvent);
-        TransientBufferId indexQueueBufferId = m_Services->TransientAllocator->CreateBufferGroup(indexQueueBufferSize, 1);
-        
-        AssetManagement::AsyncAssetEvent* newAsyncAssetEvents =
-            (AssetManagement::AsyncAssetEvent*)((char*)m_Services->TransientAllocator->GetBuffer(indexQueueBufferId) + sizeof(IndexQueue));
-        
-        IndexQueue* newIndexQueue = new (m_Services->TransientAllocator->GetBuffer(indexQueueBufferId)) IndexQueue(
-            indexQueueBufferId, newAsyncAssetEvents, m_AssetReloadQueue.size(), m_Logger, m_Services
-        );
-
-        // link the new queue into the dependency-agnostic queue
-        if (m_DependencyAgnosticIndexQueue == nullptr)
-        {
-            m_DependencyAgnosticIndexQueue = newIndexQueue;
-        }
-        else 
-        {
-            m_DependencyAgnosticIndexQueue->AddTail(newIndexQueue);
-        }
-
-        // queue these objects individually, we are not usually reloading an entire scene's worth of assets all at once
-        for (size_t i = 0; i < m_AssetReloadQueue.size(); i++)
-        {
-            auto& context = m_AssetReloadQueue[i];
-
-            context.Buffer.Type = AssetManagement::LoadBufferType::Invalid;
-
-            auto targetAssetType = m_AssetDefinitions.find(context.AssetGroupId);
-            if (targetAssetType == m_AssetDefinitions.end())
-            {
-                m_Logger.Warning("Definition not found for asset type {}:{}, reloading skipped", 
-                    context.AssetGroupId.First, 
-                    context.AssetGroupId.Second);
-                continue;
-            }
-
-            auto targetModuleState = m_Services->ModuleManager->FindModuleMutable(context.AssetGroupId.First);
-            if (targetModuleState == nullptr)
-            {
-                m_Logger.Warning("Module state not found for asset type {}, reloading skipped.", 
-                    targetAssetType->second.Name.DisplayName);
-                continue;
-            }
-
-            CallbackResult result = targetAssetType->second.Contextualize(m_Services, targetModuleState, &context, 1);
-            if (result.has_value())
-                return result;
-
-            AssetManagement::AsyncAssetEvent* persistentCopy = new (newAsyncAssetEvents + i) AssetManagement::AsyncAssetEvent(context, &targetAssetType->second, targetModuleState);
-
-            switch (context.Buffer.Type)
-            {
-            case AssetManagement::LoadBufferType::TransientBuffer:
-                transientBufferBudget += context.Buffer.Location.TransientBufferSize;
-                transientBufferCount ++;
-                break;
-            case AssetManagement::LoadBufferType::ModuleBuffer:
-                LoadAssetFileAsync(persistentCopy);
-                break;
-            case AssetManagement::LoadBufferType::Invalid:
-                m_Logger.Information("Asset {}:{} rejected by module", targetAssetType->second.Name.DisplayName, context.AssetId);
-                break;
-            }
-        }
+        std::vector<AssetManagement::AssetLoadingContext>& contextualizeQueue = m_ContextualizeQueues[priority];
+        if (contextualizeQueue.empty())
+            continue;
 
-        if (transientBufferBudget > 0)
+        size_t cursor = 0;
+        Pipeline::HashIdTuple currentGroupId = { md5::compute(""), md5::compute("") };
+        while (cursor < contextualizeQueue.size())
         {
-            TransientBufferId bufferId = m_Services->TransientAllocator->CreateBufferGroup(transientBufferBudget, transientBufferCount);
-
-            int offset = 0;
-
-            for (size_t i = 0; i < m_AssetReloadQueue.size(); i++)
+            size_t readBudget = SIZE_MAX;
+            if (m_Configs->MaxAssetReadsInFlight > 0)
             {
-                auto& currentEvent = newAsyncAssetEvents[i];
-
-                if (currentEvent.GetContext()->Buffer.Type != AssetManagement::LoadBufferType::TransientBuffer)
-                    continue;
-
-                // grant a portion of the transient buffer
-                bufferId.Child = offset;
-                offset += currentEvent.GetContext()->Buffer.Location.TransientBufferSize;
-                currentEvent.GetContext()->Buffer.Location.TransientBufferId = bufferId;
-
-                // schedule IO
-                LoadAssetFileAsync(&currentEvent);
+                if (m_ReadsInFlight >= m_Configs->MaxAssetReadsInFlight)
+                {
+                    contextualizeStopped = true;
+                    break;
+                }
+                readBudget = m_Configs->MaxAssetReadsInFlight - m_ReadsInFlight;
             }
-        }
-    }
-    m_AssetReloadQueue.clear();
 
-    // process contextualized assets
-    if (!m_ContextualizeQueue.empty())
-    {
-        size_t cursor = 0;
-        Pipeline::HashIdTuple currentGroupId = { md5::compute(""), md5::compute("") };
-        while (cursor < m_ContextualizeQueue.size())
-        {
-            currentGroupId = m_ContextualizeQueue[cursor].AssetGroupId;
+            currentGroupId = contextualizeQueue[cursor].AssetGroupId;
 
             size_t contextGroupSize = 0;
-            // asset sections are written in groups
-            while (cursor + contextGroupSize < m_ContextualizeQueue.size() && m_ContextualizeQueue[cursor + contextGroupSize].AssetGroupId == currentGroupId)
+            // asset sections are written in groups, large groups are split up to fit the read budget
+            while (cursor + contextGroupSize < contextualizeQueue.size() && contextGroupSize < readBudget && contextualizeQueue[cursor + contextGroupSize].AssetGroupId == currentGroupId)
             {
                 contextGroupSize ++;
             }
@@ -455,6 +873,10 @@ CallbackResult AssetManager::PollEvents()
                 m_Logger.Warning("Definition not found for asset type {}:{}, assets will be skipped", 
                     currentGroupId.First, 
                     currentGroupId.Second);
+                for (size_t i = 0; i < contextGroupSize; i++)
+                {
+                    UntrackPendingAsset(contextualizeQueue[cursor + i]);
+                }
             }
             else 
             {
@@ -464,6 +886,10 @@ CallbackResult AssetManager::PollEvents()
                     m_Logger.Warning("Module state not found for asset type {}:{}, loading skipped.", 
                         currentGroupId.First, 
                         currentGroupId.Second);
+                    for (size_t i = 0; i < contextGroupSize; i++)
+                    {
+                        UntrackPendingAsset(contextualizeQueue[cursor + i]);
+                    }
                 }
                 else 
                 {
@@ -474,40 +900,25 @@ CallbackResult AssetManager::PollEvents()
                     );
 
                     // batch contextualize
-                    auto result = targetAssetType->second.Contextualize(m_Services, targetModuleState, &m_ContextualizeQueue[cursor], contextGroupSize);
+                    auto result = targetAssetType->second.Contextualize(m_Services, targetModuleState, &contextualizeQueue[cursor], contextGroupSize);
                     if (result.has_value())
                         return result;
 
-                    // create a new index queue and link it to the module linked list
-                    size_t indexQueueBufferSize = sizeof(IndexQueue) + contextGroupSize * sizeof(AssetManagement::AsyncAssetEvent);
-                    TransientBufferId indexQueueBufferId = m_Services->TransientAllocator->CreateBufferGroup(indexQueueBufferSize, 1);
-                    
-                    AssetManagement::AsyncAssetEvent* newAsyncAssetEvents =
-                        (AssetManagement::AsyncAssetEvent*)((char*)m_Services->TransientAllocator->GetBuffer(indexQueueBufferId) + sizeof(IndexQueue));
-                    
-                    IndexQueue* newIndexQueue = new (m_Services->TransientAllocator->GetBuffer(indexQueueBufferId)) IndexQueue(
-                        indexQueueBufferId, newAsyncAssetEvents, contextGroupSize, m_Logger, m_Services
-                    );
-
-                    // link the new queue into the module-type-sorted collection
-                    if (m_IndexQueues[currentGroupId.First] == nullptr)
-                    {
-                        m_IndexQueues[currentGroupId.First] = newIndexQueue;
-                    }
-                    else 
-                    {
-                        m_IndexQueues[currentGroupId.First]->AddTail(newIndexQueue);
-                    }
+                    // create a new index queue for the group, its events join the wait list
+                    IndexQueue* newIndexQueue = CreateIndexQueue(contextGroupSize);
+                    AssetManagement::AsyncAssetEvent* newAsyncAssetEvents = newIndexQueue->GetEvent(0);
 
                     // collect info on transient buffer or send off the IO event
                     size_t transientBufferBudget = 0;
                     int transientBufferCount = 0;
+                    int transientReadCount = 0;
                     for (size_t i = 0; i < contextGroupSize; i++)
                     {
                         // assign the new event into the new index queue; 
                         // this will be the persistent location until the task is finished 
                         // (we need to pass opaque pointers around)
-                        AssetManagement::AsyncAssetEvent* persistentCopy = new (newAsyncAssetEvents + i) AssetManagement::AsyncAssetEvent(m_ContextualizeQueue[cursor + i], &targetAssetType->second, targetModuleState);
+                        AssetManagement::AsyncAssetEvent* persistentCopy = new (newAsyncAssetEvents + i) AssetManagement::AsyncAssetEvent(contextualizeQueue[cursor + i], &targetAssetType->second, targetModuleState);
+                        m_IndexWaitList.push_back({ persistentCopy, newIndexQueue });
 
                         switch (persistentCopy->GetContext()->Buffer.Type)
                         {
@@ -524,9 +935,24 @@ CallbackResult AssetManager::PollEvents()
                             // we batch transient requests together to reduce memory alllocation frequency
                             transientBufferBudget += persistentCopy->GetContext()->Buffer.Location.TransientBufferSize;
                             transientBufferCount++;
+
+                            // packed assets are copied and compressed ones are read into a staging buffer
+                            if (persistentCopy->GetContext()->MappedSource == nullptr
+                                && persistentCopy->GetContext()->CompressedSource == nullptr
+                                && persistentCopy->GetContext()->CompressedSize == 0)
+                                transientReadCount++;
                             break;
                         case AssetManagement::LoadBufferType::ModuleBuffer:
-                            LoadAssetFileAsync(persistentCopy);
+                            // an event whose read never went out would hold up the index queue forever
+                            if (!LoadAssetFileAsync(persistentCopy))
+                            {
+                                persistentCopy->MakeBroken();
+                                persistentCopy->MakeAvailable();
+                            }
+                            break;
+                        case AssetManagement::LoadBufferType::MappedBuffer:
+                            // zero copy, the blob can be processed right away
+                            OnAssetLoaded(persistentCopy);
                             break;
                         default:
                             break;
@@ -538,6 +964,12 @@ CallbackResult AssetManager::PollEvents()
                     {
                         TransientBufferId bufferId = m_Services->TransientAllocator->CreateBufferGroup(transientBufferBudget, transientBufferCount);
 
+                        // the whole group is registered with the IO backend while its reads are queued, if there are
+                        // enough of them to make up for the registration
+                        void* bufferBase = transientReadCount >= MinRegisteredGroupReads ? m_Services->TransientAllocator->GetBuffer(bufferId) : nullptr;
+                        if (bufferBase != nullptr)
+                            m_IoBackend->RegisterBuffer(bufferBase, transientBufferBudget);
+
                         int offset = 0;
 
                         for (size_t i = 0; i < contextGroupSize; i++)
@@ -553,17 +985,222 @@ CallbackResult AssetManager::PollEvents()
                             currentEvent.GetContext()->Buffer.Location.TransientBufferId = bufferId;
 
                             // schedule IO
-                            LoadAssetFileAsync(&currentEvent);
+                            if (!LoadAssetFileAsync(&currentEvent))
+                            {
+                                currentEvent.MakeBroken();
+                                currentEvent.MakeAvailable();
+                            }
                         }
+
+                        if (bufferBase != nullptr)
+                            m_IoBackend->UnregisterBuffer(bufferBase);
                     }
                 }
             }
 
             cursor += contextGroupSize;
             currentGroupId.First = md5::compute("");
+
+            // groups are contextualized as a whole, the ones left over wait at the front of the queue
+            if (SDL_GetTicksNS() >= deadline)
+            {
+                contextualizeStopped = true;
+                break;
+            }
+        }
+
+        contextualizeQueue.erase(contextualizeQueue.begin(), contextualizeQueue.begin() + cursor);
+    }
+
+    // everything read this poll goes to the OS as one batch
+    m_IoBackend->Submit();
+
+    // unload what nobody uses anymore if the cache grew beyond its budget
+    if (m_BudgetCheckPending)
+        return EnforceMemoryBudget();
+
+    return CallbackSuccess();
+}
+
+AssetManager::AssetRecord& AssetManager::AcquireAsset(const AssetKey& key)
+{
+    AssetRecord& record = m_AssetRecords[key];
+    record.ReferenceCount++;
+    return record;
+}
+
+void AssetManager::ReleaseAsset(const AssetKey& key)
+{
+    auto record = m_AssetRecords.find(key);
+    if (record == m_AssetRecords.end() || record->second.ReferenceCount == 0)
+    {
+        m_Logger.Warning("Asset {} released more often than it was acquired.", key.AssetId);
+        return;
+    }
+
+    record->second.ReferenceCount--;
+    if (record->second.ReferenceCount > 0)
+        return;
+
+    // an asset that never made it (its load failed) has nothing to cache
+    if (!record->second.Resident && record->second.LoadsInFlight == 0)
+    {
+        m_AssetRecords.erase(record);
+        return;
+    }
+
+    record->second.ReleasedAt = ++m_ReleaseClock;
+    m_BudgetCheckPending = true;
+}
+
+bool AssetManager::IsAssetReferenced(const AssetManagement::AssetLoadingContext& context) const
+{
+    auto record = m_AssetRecords.find({ context.AssetGroupId, context.AssetId });
+    return record != m_AssetRecords.end() && record->second.ReferenceCount > 0;
+}
+
+void AssetManager::ReleaseEntityAssets(Pipeline::HashId entityId)
+{
+    auto references = m_EntityAssetReferences.find(entityId);
+    if (references == m_EntityAssetReferences.end())
+        return;
+
+    for (const AssetKey& key : references->second)
+    {
+        ReleaseAsset(key);
+    }
+
+    m_Logger.Information("Entity {} released {} asset reference(s).", entityId, references->second.size());
+    m_EntityAssetReferences.erase(references);
+}
+
+bool AssetManager::HasQueuedContexts() const
+{
+    for (const auto& contextualizeQueue : m_ContextualizeQueues)
+    {
+        if (!contextualizeQueue.empty())
+            return true;
+    }
+
+    return false;
+}
+
+void AssetManager::DropUnreferencedContexts()
+{
+    // work that hasn't been sent to IO yet is dropped when nobody references the asset anymore,
+    // explicit reloads are kept because they target assets that are already resident
+    size_t dropped = 0;
+    for (auto& contextualizeQueue : m_ContextualizeQueues)
+    {
+        auto firstDropped = std::remove_if(contextualizeQueue.begin(), contextualizeQueue.end(), [this](const AssetManagement::AssetLoadingContext& context) {
+            return !context.ReplaceExisting && !IsAssetReferenced(context);
+        });
+
+        for (auto it = firstDropped; it != contextualizeQueue.end(); it++)
+        {
+            UntrackPendingAsset(*it);
         }
+
+        dropped += contextualizeQueue.end() - firstDropped;
+        contextualizeQueue.erase(firstDropped, contextualizeQueue.end());
     }
-    m_ContextualizeQueue.clear();
+
+    if (dropped > 0)
+        m_Logger.Information("Dropped {} queued asset load(s) that are no longer referenced.", dropped);
+}
+
+void AssetManager::CancelEntity(Pipeline::HashId entityId)
+{
+    // SDL can't abort a read that has been issued, the entity is discarded when its read completes
+    for (auto& entityEvent : m_EntityLoadingQueue)
+    {
+        if (entityEvent->GetId() == entityId && !entityEvent->IsCanceled())
+        {
+            entityEvent->Cancel();
+            m_Logger.Information("Entity {} loading canceled.", entityId);
+        }
+    }
+
+    ReleaseEntityAssets(entityId);
+    DropUnreferencedContexts();
+}
+
+void AssetManager::OnAssetIndexed(const AssetManagement::AssetLoadingContext* context)
+{
+    // reloads of assets no entity asked for create their record here, they are unreferenced from the start
+    auto inserted = m_AssetRecords.try_emplace({ context->AssetGroupId, context->AssetId });
+    AssetRecord& record = inserted.first->second;
+    if (inserted.second)
+        record.ReleasedAt = ++m_ReleaseClock;
+
+    // the source size is a close enough estimate of what modules keep (GPU buffers, blobs, compiled code)
+    if (record.Resident)
+        m_ResidentAssetBytes -= record.Footprint;
+    record.Footprint = context->SourceSize;
+    record.Resident = true;
+    m_ResidentAssetBytes += record.Footprint;
+
+    m_BudgetCheckPending = true;
+}
+
+CallbackResult AssetManager::EnforceMemoryBudget()
+{
+    m_BudgetCheckPending = false;
+    if (m_ResidentAssetBytes <= m_Configs->AssetMemoryBudget)
+        return CallbackSuccess();
+
+    // assets still waiting to be indexed may need the ones they depend on even if no entity references those
+    std::unordered_set<Pipeline::HashId> neededDependencies;
+    for (const IndexWaiter& waiter : m_IndexWaitList)
+    {
+        // dependencies are complete once the event is available, a process stage may still be adding to them
+        if (!waiter.Event->IsAvailable())
+            continue;
+
+        const AssetManagement::AssetLoadingContext* context = waiter.Event->GetContext();
+        neededDependencies.insert(context->Dependencies, context->Dependencies + context->DependencyCount);
+    }
+
+    // only indexed assets can be unloaded, the ones still in flight (reloads included) are checked again once they are indexed
+    std::vector<std::pair<Uint64, AssetKey>> candidates;
+    for (const auto& record : m_AssetRecords)
+    {
+        if (record.second.Resident && record.second.ReferenceCount == 0 && record.second.LoadsInFlight == 0 && neededDependencies.count(record.first.AssetId) == 0)
+            candidates.push_back({ record.second.ReleasedAt, record.first });
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t unloadedCount = 0;
+    size_t unloadedBytes = 0;
+    for (const auto& candidate : candidates)
+    {
+        if (m_ResidentAssetBytes <= m_Configs->AssetMemoryBudget)
+            break;
+
+        auto record = m_AssetRecords.find(candidate.second);
+        auto definition = m_AssetDefinitions.find(candidate.second.AssetGroupId);
+        if (definition == m_AssetDefinitions.end() || definition->second.Unload == nullptr)
+            continue;
+
+        void* moduleState = m_Services->ModuleManager->FindModuleMutable(candidate.second.AssetGroupId.First);
+        if (moduleState == nullptr)
+            continue;
+
+        CallbackResult result = definition->second.Unload(m_Services, moduleState, candidate.second.AssetId);
+        if (result.has_value())
+            return result;
+
+        m_ResidentAssetBytes -= record->second.Footprint;
+        unloadedBytes += record->second.Footprint;
+        unloadedCount++;
+        m_AssetRecords.erase(record);
+    }
+
+    if (unloadedCount > 0)
+        m_Logger.Information("Unloaded {} asset(s) ({} bytes) to stay within the asset memory budget.", unloadedCount, unloadedBytes);
+
+    if (m_ResidentAssetBytes > m_Configs->AssetMemoryBudget)
+        m_Logger.Warning("Loaded assets take {} bytes, {} more than the budget allows, but the rest is still in use.", m_ResidentAssetBytes, m_ResidentAssetBytes - m_Configs->AssetMemoryBudget);
 
     return CallbackSuccess();
 }
@@ -588,19 +1225,32 @@ void Engine::Core::Runtime::AssetManager::ProcessComponentGroup(Utils::Memory::M
     targetComponent->second.Load(componentCount, stream, m_Services, targetModuleState);
 }
 
-Engine::Core::Runtime::AssetManager::AssetManager(Engine::Core::Pipeline::ModuleAssembly modules, Logging::LoggerService *loggerService, ServiceTable *services)
-    : m_Logger(loggerService->CreateLogger("AssetManager")),
-      m_Services(services) 
+Engine::Core::Runtime::AssetManager::AssetManager(Engine::Core::Pipeline::ModuleAssembly modules, const Configuration::ConfigurationProvider* configs, Logging::LoggerService *loggerService, ServiceTable *services)
+    : m_Configs(configs),
+      m_Logger(loggerService->CreateLogger("AssetManager")),
+      m_Services(services),
+      m_ReadsInFlight(0),
+      m_ResidentAssetBytes(0),
+      m_ReleaseClock(0),
+      m_BudgetCheckPending(false)
 {
-    m_DependencyAgnosticIndexQueue = nullptr;
-
     m_StorageFolder = SDL_OpenTitleStorage(".", 0);
     if (m_StorageFolder == nullptr)
     {
         m_Logger.Error("SDL failed to open title storage at the working directory, detail: {}", SDL_GetError());
     }
 
-    m_AsyncQueue = SDL_CreateAsyncIOQueue();
+    m_IoBackend = AssetManagement::CreateAssetIoBackend(configs);
+    m_Logger.Information("Reading assets through {}.", m_IoBackend->GetName());
+
+    if (m_Archive.Open(Configuration::AssetArchiveName))
+    {
+        m_Logger.Information("Mapped asset archive {} with {} assets.", Configuration::AssetArchiveName, m_Archive.GetEntryCount());
+    }
+    else
+    {
+        m_Logger.Information("No usable asset archive at {}, assets are loaded as loose files.", Configuration::AssetArchiveName);
+    }
 
     // process and cache per-module information
     for (size_t i = 0; i < modules.ModuleCount; i++)
@@ -622,14 +1272,25 @@ Engine::Core::Runtime::AssetManager::AssetManager(Engine::Core::Pipeline::Module
             Pipeline::HashIdTuple tuple { module.Name.Hash, asset.Name.Hash };
             m_AssetDefinitions[tuple] = asset;
         }
-
-        // allocate a null linked list header
-        m_IndexQueues[module.Name.Hash] = nullptr;
     }
 }
 
 AssetManager::~AssetManager()
 {
+    // processing tasks write into index queue buffers
+    m_Services->TaskManager->Join(&m_ProcessTasks);
+
+    // lookups still running on workers reference the storage and their batch
+    m_Services->TaskManager->Join(&m_SizeTasks);
+
     SDL_CloseStorage(m_StorageFolder);
-    SDL_DestroyAsyncIOQueue(m_AsyncQueue);
+
+    // waits for the reads still running
+    m_IoBackend.reset();
+
+    // a batch that never finished indexing may still hold a process error
+    for (IndexQueue* queue : m_IndexQueues)
+    {
+        queue->DestroyEvents();
+    }
 }
\ No newline at end of file
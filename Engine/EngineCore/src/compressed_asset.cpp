@@ -0,0 +1,110 @@
+#include "EngineCore/AssetManagement/compressed_asset.h"
+#include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/parallel_for.h"
+#include "EngineUtils/Compression/block_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Engine::Core::AssetManagement;
+using namespace Engine::Core::Runtime;
+
+struct DecompressionState
+{
+    const unsigned char* Data;
+    size_t Size;
+    const CompressedAssetBlock* Blocks;
+    unsigned char* Destination;
+    CompressedAssetHeader Header;
+};
+
+static CallbackResult DecompressBlocks(void* state, size_t begin, size_t end)
+{
+    auto decompression = (DecompressionState*)state;
+    const CompressedAssetHeader& header = decompression->Header;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const CompressedAssetBlock& block = decompression->Blocks[i];
+        size_t blockStart = i * header.BlockSize;
+        size_t blockSize = std::min<size_t>(header.BlockSize, (size_t)header.UncompressedSize - blockStart);
+
+        if (block.Offset > decompression->Size || block.Size > decompression->Size - block.Offset)
+            return Crash(__FILE__, __LINE__, "Compressed asset block out of bounds.");
+
+        const unsigned char* source = decompression->Data + block.Offset;
+        unsigned char* destination = decompression->Destination + blockStart;
+        if (block.Size == blockSize)
+        {
+            memcpy(destination, source, blockSize);
+        }
+        else if (!Engine::Utils::Compression::DecompressBlock(source, (size_t)block.Size, destination, blockSize))
+        {
+            return Crash(__FILE__, __LINE__, "Compressed asset block is corrupted.");
+        }
+    }
+
+    return CallbackSuccess();
+}
+
+bool Engine::Core::AssetManagement::ReadCompressedAssetHeader(const void* data, size_t size, CompressedAssetHeader* outHeader)
+{
+    if (size < sizeof(CompressedAssetHeader))
+        return false;
+
+    CompressedAssetHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.MagicWord != CompressedAssetMagicWord || header.BlockSize == 0)
+        return false;
+
+    // the block count has to match the size, and the table has to fit
+    uint64_t expectedBlocks = (header.UncompressedSize + header.BlockSize - 1) / header.BlockSize;
+    if (header.BlockCount != expectedBlocks || header.BlockCount > (size - sizeof(CompressedAssetHeader)) / sizeof(CompressedAssetBlock))
+        return false;
+
+    *outHeader = header;
+    return true;
+}
+
+bool Engine::Core::AssetManagement::DecompressAsset(Runtime::ITaskScheduler* scheduler, const void* data, size_t size, void* destination, size_t destinationSize)
+{
+    DecompressionState state;
+    if (!ReadCompressedAssetHeader(data, size, &state.Header) || state.Header.UncompressedSize != destinationSize)
+        return false;
+
+    state.Data = static_cast<const unsigned char*>(data);
+    state.Size = size;
+    state.Blocks = reinterpret_cast<const CompressedAssetBlock*>(state.Data + sizeof(CompressedAssetHeader));
+    state.Destination = static_cast<unsigned char*>(destination);
+
+    // one block per chunk, blocks are large enough to be worth a runner each
+    return !ParallelFor(scheduler, 0, (size_t)state.Header.BlockCount, 1, DecompressBlocks, &state).has_value();
+}
+
+void Engine::Core::AssetManagement::CompressAsset(const void* source, size_t size, size_t blockSize, std::vector<unsigned char>& output)
+{
+    const unsigned char* input = static_cast<const unsigned char*>(source);
+
+    CompressedAssetHeader header { CompressedAssetMagicWord, (uint32_t)blockSize, size, (size + blockSize - 1) / blockSize };
+    size_t tableSize = sizeof(CompressedAssetHeader) + header.BlockCount * sizeof(CompressedAssetBlock);
+
+    output.assign(tableSize, 0);
+    memcpy(output.data(), &header, sizeof(header));
+
+    std::vector<unsigned char> scratch(Engine::Utils::Compression::BlockCompressBound(blockSize));
+    for (uint64_t i = 0; i < header.BlockCount; i++)
+    {
+        size_t blockStart = i * blockSize;
+        size_t currentSize = std::min(blockSize, size - blockStart);
+
+        // blocks that don't shrink are stored as they are, the capacity makes the codec give up early on them
+        size_t compressedSize = Engine::Utils::Compression::CompressBlock(input + blockStart, currentSize, scratch.data(), currentSize - 1);
+        CompressedAssetBlock block { output.size(), compressedSize > 0 ? compressedSize : currentSize };
+        if (compressedSize > 0)
+            output.insert(output.end(), scratch.begin(), scratch.begin() + compressedSize);
+        else
+            output.insert(output.end(), input + blockStart, input + blockStart + currentSize);
+
+        memcpy(output.data() + sizeof(CompressedAssetHeader) + i * sizeof(CompressedAssetBlock), &block, sizeof(block));
+    }
+}
@@ -2,7 +2,9 @@
 #include "EngineCore/Runtime/event_writer.h"
 
 #include "EngineCore/Logging/logger_service.h"
+#include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/service_table.h"
+#include "EngineCore/Runtime/task_manager.h"
 
 using namespace Engine::Core::Runtime;
 
@@ -16,18 +18,56 @@ void EventManager::RegisterEventSystem(const EventSystemInstance* systems, size_
     for (size_t i = 0; i < systemCount; i++)
     {
         m_Systems.push_back(systems[i]);
+        m_Writers.emplace_back();
     }
 }
 
-bool EventManager::ExecuteAllSystems(ServiceTable* services, EventWriter& writer)
+static CallbackResult RunEventSystem(void* state)
 {
-    writer.Initialize();
+    auto task = (EventSystemTask*)state;
+    task->System->Delegate(task->Services, task->System->SystemLocalState, task->Writer);
+    return CallbackSuccess();
+}
 
-    for (const EventSystemInstance& system : m_Systems)
+bool EventManager::ExecuteAllSystems(ServiceTable* services)
+{
+    // the task list is rebuilt every pass, writers and systems can be added between frames
+    m_SystemTasks.clear();
+    for (size_t i = 0; i < m_Systems.size(); i++)
     {
-        writer.m_UserName = system.Name;
-        system.Delegate(services, system.SystemLocalState, &writer);
+        m_Writers[i].Initialize();
+        m_Writers[i].m_UserName = m_Systems[i].Name;
+        m_SystemTasks.push_back({ services, &m_Systems[i], &m_Writers[i] });
     }
 
-    return writer.HasEvents();
-}
\ No newline at end of file
+    TaskCounter counter;
+    for (EventSystemTask& systemTask : m_SystemTasks)
+    {
+        Task task;
+        task.Type = TaskType::GenericTask;
+        task.Payload.GenericTask = { RunEventSystem, &systemTask };
+        services->TaskManager->ScheduleWork(task, &counter);
+    }
+
+    // systems don't report errors, the join only waits for them
+    services->TaskManager->Join(&counter);
+
+    // a system writing for an owner nobody registered would likely do so every frame, once is enough to tell
+    for (size_t i = 0; i < m_Writers.size(); i++)
+    {
+        EventWriter& writer = m_Writers[i];
+        if (writer.m_DroppedEvents > 0 && !writer.m_DropsReported)
+        {
+            m_Logger.Warning("Event system {} wrote {} event(s) for an unregistered or out of range owner, they were dropped.", m_Systems[i].Name, writer.m_DroppedEvents);
+            writer.m_DropsReported = true;
+        }
+    }
+
+    for (const EventWriter& writer : m_Writers)
+    {
+        if (writer.HasEvents())
+            return true;
+    }
+
+    return false;
+}
@@ -1,26 +1,110 @@
 #include "EngineCore/Runtime/event_stream.h"
+#include "EngineCore/Runtime/event_writer.h"
 #include <cstring>
 
 using namespace Engine::Core::Runtime;
 
+bool EventStream::Seek()
+{
+    // skip to the next page, bucket or writer holding anything; pages of a bucket are filled in order, so the first
+    // empty page ends the bucket
+    while (m_Writer < m_WriterCount)
+    {
+        const std::vector<EventBucket>& buckets = m_Writers[m_Writer].m_Buckets;
+
+        if (m_Bucket < buckets.size())
+        {
+            const std::vector<EventPage>& pages = buckets[m_Bucket].Pages;
+
+            if (m_Page < pages.size() && m_Offset < pages[m_Page].Used)
+                return true;
+
+            if (m_Page + 1 < pages.size() && pages[m_Page + 1].Used > 0)
+            {
+                m_Page++;
+                m_Offset = 0;
+                continue;
+            }
+        }
+
+        // this bucket is done
+        m_Page = 0;
+        m_Offset = 0;
+        if (m_BucketFilter < 0 && m_Bucket + 1 < buckets.size())
+        {
+            m_Bucket++;
+        }
+        else
+        {
+            m_Writer++;
+            m_Bucket = m_BucketFilter < 0 ? 0 : m_BucketFilter;
+        }
+    }
+
+    return false;
+}
+
 bool EventStream::MoveNext()
 {
-    // increment cursor
-    EventHeader header = GetCurrentHeader();
-    m_Cursor += sizeof(EventHeader) + header.Length;
+    if (m_Started)
+    {
+        // increment cursor past the current event
+        const EventBucket& bucket = m_Writers[m_Writer].m_Buckets[m_Bucket];
+        m_Offset += bucket.Packed ? bucket.Stride : EventWriter::GetAlignedEventSize(GetCurrentHeader().Length);
+    }
+    m_Started = true;
+
+    return Seek();
+}
+
+bool EventStream::MoveNextPage()
+{
+    if (m_Started)
+        m_Offset = m_Writers[m_Writer].m_Buckets[m_Bucket].Pages[m_Page].Used;
+    m_Started = true;
+
+    return Seek();
+}
 
-    // align to longest alignment
-    m_Cursor -= 1;
-    m_Cursor = m_Cursor - (m_Cursor % sizeof(size_t)) + sizeof(size_t);
-    return m_Cursor < m_Data->size();
+const unsigned char* EventStream::GetCurrentEvent() const
+{
+    return m_Writers[m_Writer].m_Buckets[m_Bucket].Pages[m_Page].Data + m_Offset;
+}
+
+const unsigned char* EventStream::GetCurrentPage(size_t* outSize) const
+{
+    const EventPage& page = m_Writers[m_Writer].m_Buckets[m_Bucket].Pages[m_Page];
+    *outSize = page.Used;
+    return page.Data;
 }
 
 EventHeader EventStream::GetCurrentHeader() const
 {
-    return *(EventHeader*)(m_Data->data() + m_Cursor);
+    // packed events don't store a header, their bucket knows everything about them
+    const EventBucket& bucket = m_Writers[m_Writer].m_Buckets[m_Bucket];
+    if (bucket.Packed)
+        return { (uint16_t)m_Bucket, UnknownEventAuthor, (uint32_t)bucket.Stride };
+
+    EventHeader header;
+    memcpy(&header, GetCurrentEvent(), sizeof(EventHeader));
+    return header;
+}
+
+EventAuthor EventStream::GetCurrentAuthor() const
+{
+    const std::vector<EventAuthor>& authors = m_Writers[m_Writer].m_Authors;
+
+    EventHeader header = GetCurrentHeader();
+    if (header.Author >= authors.size())
+        return { nullptr, 0 };
+
+    return authors[header.Author];
 }
 
 const void* EventStream::GetCurrentData() const
 {
-    return m_Data->data() + m_Cursor + sizeof(EventHeader);
-}
\ No newline at end of file
+    if (m_Writers[m_Writer].m_Buckets[m_Bucket].Packed)
+        return GetCurrentEvent();
+
+    return GetCurrentEvent() + sizeof(EventHeader);
+}
@@ -1,20 +1,146 @@
 #include "EngineCore/Runtime/event_writer.h"
+#include "EngineCore/Configuration/configuration_provider.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 
 using namespace Engine::Core::Runtime;
 
-void EventWriter::Write(void* owner, const void* data, size_t length, const char* authorName, int authorPath)
+EventWriter::EventWriter(EventWriter&& other) noexcept
+    : m_UserName(other.m_UserName),
+    m_Buckets(std::move(other.m_Buckets)),
+    m_Journal(std::move(other.m_Journal)),
+    m_Authors(std::move(other.m_Authors)),
+    m_DroppedEvents(other.m_DroppedEvents),
+    m_DropsReported(other.m_DropsReported)
+{
+    other.m_Buckets.clear();
+    other.m_Journal.clear();
+    other.m_Authors.clear();
+}
+
+EventWriter::~EventWriter()
+{
+    for (EventBucket& bucket : m_Buckets)
+    {
+        for (EventPage& page : bucket.Pages)
+        {
+            free(page.Data);
+        }
+    }
+}
+
+unsigned char* EventWriter::Reserve(EventBucket& bucket, size_t totalLength)
+{
+    if (bucket.CurrentPage < bucket.Pages.size())
+    {
+        EventPage& current = bucket.Pages[bucket.CurrentPage];
+        if (current.Used + totalLength <= current.Capacity)
+        {
+            unsigned char* destination = current.Data + current.Used;
+            current.Used += totalLength;
+            return destination;
+        }
+
+        // move on to the next page, an empty current page is only too small for this event
+        if (current.Used > 0)
+            bucket.CurrentPage++;
+    }
+
+    size_t capacity = std::max(Configuration::EventPageSize, totalLength);
+    if (bucket.CurrentPage == bucket.Pages.size())
+    {
+        bucket.Pages.push_back({ (unsigned char*)malloc(capacity), capacity, 0 });
+    }
+    else if (bucket.Pages[bucket.CurrentPage].Capacity < totalLength)
+    {
+        // pages after the current one are always empty, so it's safe to swap in a bigger buffer
+        free(bucket.Pages[bucket.CurrentPage].Data);
+        bucket.Pages[bucket.CurrentPage] = { (unsigned char*)malloc(capacity), capacity, 0 };
+    }
+
+    EventPage& page = bucket.Pages[bucket.CurrentPage];
+    page.Used = totalLength;
+    return page.Data;
+}
+
+EventBucket* EventWriter::GetBucket(int ownerId)
+{
+    // headers only have room for 16 bit owner ids, anything above would be read back as another owner
+    if (ownerId < 0 || ownerId > UINT16_MAX)
+        return nullptr;
+
+    if ((size_t)ownerId >= m_Buckets.size())
+        m_Buckets.resize(ownerId + 1);
+
+    return &m_Buckets[ownerId];
+}
+
+uint16_t EventWriter::GetAuthorIndex(const char* authorName, int authorPath)
 {
-    // calculate total length written
-    size_t totalLength = sizeof(EventHeader) + length;
-    totalLength -= 1;
-    totalLength = totalLength - (totalLength % sizeof(size_t)) + sizeof(size_t);
+    if (!m_Authors.empty() && m_Authors.back().Name == authorName && m_Authors.back().Path == authorPath)
+        return (uint16_t)(m_Authors.size() - 1);
+
+    // the last index is reserved for unknown authors
+    if (m_Authors.size() >= UnknownEventAuthor)
+        return UnknownEventAuthor;
 
-    // increment data position
-    size_t cursor = m_Data.size();
-    m_Data.resize(m_Data.size() + totalLength);
+    m_Authors.push_back({ authorName, authorPath });
+    return (uint16_t)(m_Authors.size() - 1);
+}
+
+void EventWriter::Write(int ownerId, const void* data, size_t length, const char* authorName, int authorPath)
+{
+    EventBucket* bucket = GetBucket(ownerId);
+    if (bucket == nullptr)
+    {
+        m_DroppedEvents++;
+        return;
+    }
+
+    size_t totalLength = GetAlignedEventSize(length);
+    unsigned char* destination = Reserve(*bucket, totalLength);
+    m_Journal.push_back({ (unsigned int)ownerId, (unsigned int)totalLength });
 
     // insert data
-    EventHeader header { owner, length, authorName, authorPath };
-    memcpy(m_Data.data() + cursor, &header, sizeof(header));
-    memcpy(m_Data.data() + cursor + sizeof(header), data, length);
-}
\ No newline at end of file
+    EventHeader header { (uint16_t)ownerId, GetAuthorIndex(authorName, authorPath), (uint32_t)length };
+    memcpy(destination, &header, sizeof(header));
+    memcpy(destination + sizeof(header), data, length);
+}
+
+void EventWriter::WritePacked(int ownerId, const void* data, size_t length)
+{
+    EventBucket* bucket = GetBucket(ownerId);
+    if (bucket == nullptr)
+    {
+        m_DroppedEvents++;
+        return;
+    }
+
+    // the size of a type is a multiple of its alignment, so back to back payloads stay aligned
+    bucket->Packed = true;
+    bucket->Stride = length;
+
+    unsigned char* destination = Reserve(*bucket, length);
+    m_Journal.push_back({ (unsigned int)ownerId, (unsigned int)length });
+    memcpy(destination, data, length);
+}
+
+void EventWriter::Rollback(EventWriterCheckpoint checkpoint)
+{
+    // undo writes newest first, each one is the last event of its bucket at that point
+    while (m_Journal.size() > checkpoint.EventCount)
+    {
+        EventJournalEntry entry = m_Journal.back();
+        m_Journal.pop_back();
+
+        EventBucket& bucket = m_Buckets[entry.Bucket];
+        EventPage& page = bucket.Pages[bucket.CurrentPage];
+        page.Used -= entry.Size;
+
+        // the previous page still has its fill level, continue appending there
+        if (page.Used == 0 && bucket.CurrentPage > 0)
+            bucket.CurrentPage--;
+    }
+}
@@ -11,6 +11,7 @@
 #include "EngineCore/Runtime/graphics_layer.h"
 #include "EngineCore/Runtime/input_manager.h"
 #include "EngineCore/Runtime/network_layer.h"
+#include "EngineCore/Runtime/root_module.h"
 #include "EngineCore/Runtime/service_table.h"
 #include "EngineCore/Runtime/world_state.h"
 #include "EngineCore/Runtime/module_manager.h"
@@ -26,6 +27,12 @@
 
 using namespace Engine::Core::Runtime;
 
+static SDL_InitFlags GetSdlInitFlags(const Engine::Core::Configuration::ConfigurationProvider& configs)
+{
+    // video brings in the event subsystem, headless runs still need it for input and quit requests
+    return configs.Headless ? SDL_INIT_EVENTS : SDL_INIT_VIDEO;
+}
+
 GameLoop::GameLoop(Pipeline::ModuleAssembly modules, const Configuration::ConfigurationProvider& configs) : 
     m_ConfigurationProvider(configs),
     m_Modules(modules)
@@ -60,7 +67,7 @@ CallbackResult GameLoop::DiagnsoticModeCore(std::function<void(IGameLoopControll
 CallbackResult GameLoop::DiagnsoticMode(std::function<void(IGameLoopController*)> executor)
 {
     // initialize sdl
-	if (!SDL_Init(SDL_INIT_VIDEO))
+	if (!SDL_Init(GetSdlInitFlags(m_ConfigurationProvider)))
 	{
         std::string error("SDL initialization failed, error: ");
         error.append(SDL_GetError());
@@ -93,38 +100,58 @@ CallbackResult GameLoop::RunCore(Pipeline::HashId initialEntityId)
 
     // game loop
     bool quit = false;
+    size_t frameCount = 0;
     while (!quit)
     {
         gameresult = controller.PollAsyncIoEvents();
         if (gameresult.has_value())
             return gameresult;
 
-        quit = controller.m_InputManager.m_QuitRequested;
+        frameCount++;
+        quit = controller.m_InputManager.m_QuitRequested
+            || (m_ConfigurationProvider.FrameLimit != 0 && frameCount >= m_ConfigurationProvider.FrameLimit);
 
-        // pre-update
-        gameresult = controller.Preupdate();
+        // advance the clock and take input once per rendered frame
+        gameresult = controller.Tick();
         if (gameresult.has_value())
             return gameresult;
 
-        // event loop
-        gameresult = controller.EventUpdate();
-        if (gameresult.has_value())
-            return gameresult;
+        // pipelined: the frame rendered here is the one simulated during the last iteration, and the simulation of the
+        // next one overlaps with command recording
+        bool pipelined = m_ConfigurationProvider.PipelinedSimulation;
+        TaskCounter simulation;
+        if (pipelined)
+        {
+            controller.PrepareRenderState(true);
 
-        // enter rendering critical path
-        gameresult = controller.BeginFrame();
-        if (gameresult.has_value())
-            return gameresult;
+            Task task;
+            task.Type = TaskType::GenericTask;
+            task.Payload.GenericTask = { GameLoopController::SimulateTask, &controller };
+            controller.m_TaskManager.ScheduleWork(task, &simulation);
+        }
+        else
+        {
+            gameresult = controller.Simulate();
+            if (gameresult.has_value())
+                return gameresult;
 
-        // render pass
-        gameresult = controller.RenderPass();
-        if (gameresult.has_value())
-            return gameresult;
-        
-        // last step in the update loop
-        gameresult = controller.EndFrame();
+            controller.PrepareRenderState(false);
+        }
+
+        // enter rendering critical path, then the render pass and the last step in the update loop
+        gameresult = controller.BeginFrame();
+        if (!gameresult.has_value())
+            gameresult = controller.RenderPass();
+        if (!gameresult.has_value())
+            gameresult = controller.EndFrame();
+
+        // nothing may touch the simulation state before the overlapped steps finished, failed frame or not; the
+        // simulation runs against the controller and the counter, both gone once this returns
+        CallbackResult simulationResult = controller.m_TaskManager.Join(&simulation);
         if (gameresult.has_value())
             return gameresult;
+        if (simulationResult.has_value())
+            return simulationResult;
     }
 
     controller.UnloadModules();
@@ -134,7 +161,7 @@ CallbackResult GameLoop::RunCore(Pipeline::HashId initialEntityId)
 CallbackResult GameLoop::Run(Pipeline::HashId initialEntityId) 
 {
     // initialize sdl
-	if (!SDL_Init(SDL_INIT_VIDEO))
+	if (!SDL_Init(GetSdlInitFlags(m_ConfigurationProvider)))
 	{
         std::string error("SDL initialization failed, error: ");
         error.append(SDL_GetError());
@@ -166,17 +193,18 @@ static const char* TopLevelLogChannels[] = { "GameLoop" };
 
 GameLoop::GameLoopController::GameLoopController(Engine::Core::Pipeline::ModuleAssembly modules, Engine::Core::Configuration::ConfigurationProvider configs, GameLoop* owner)
     : m_LoggerService(configs),
-    m_GraphicsLayer(&configs, &m_LoggerService),
-    m_WorldState(&configs),
+    m_MemoryTracker(&owner->m_ConfigurationProvider, &m_LoggerService),
+    m_TransientAllocator(&m_LoggerService, &m_MemoryTracker),
+    m_HeapAllocator(&m_MemoryTracker),
+    m_ContainerFactory(&m_LoggerService, &m_HeapAllocator),
+    m_GraphicsLayer(&owner->m_ConfigurationProvider, &m_LoggerService),
+    m_WorldState(&owner->m_ConfigurationProvider),
     m_ModuleManager(&m_LoggerService),
     m_EventManager(&m_LoggerService),
     m_InputManager(),
     m_NetworkLayer(&m_LoggerService),
     m_TaskManager(&m_Services, &m_LoggerService, configs.WorkerCount),
-    m_TransientAllocator(&m_LoggerService),
-    m_AssetManager(modules, &m_LoggerService, &m_Services),
-    m_HeapAllocator(),
-    m_ContainerFactory(&m_LoggerService),
+    m_AssetManager(modules, &owner->m_ConfigurationProvider, &m_LoggerService, &m_Services),
     m_Services {
         &m_LoggerService,
         &m_GraphicsLayer,
@@ -189,11 +217,11 @@ GameLoop::GameLoopController::GameLoopController(Engine::Core::Pipeline::ModuleA
         &m_TransientAllocator,
         &m_AssetManager,
         &m_HeapAllocator,
-        &m_ContainerFactory
+        &m_ContainerFactory,
+        &m_MemoryTracker
     },
     m_Owner(owner),
-    m_TopLevelLogger(m_LoggerService.CreateLogger("GameLoop")),
-    m_EventWriter()
+    m_TopLevelLogger(m_LoggerService.CreateLogger("GameLoop"))
 {
     for (const auto& system : owner->m_EventSystems)
     {
@@ -226,7 +254,15 @@ Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopC
 
 Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::UnloadModules() 
 {
-    return m_ModuleManager.UnloadModules();
+    CallbackResult result = m_ModuleManager.UnloadModules();
+
+    // whatever is still allocated once the modules are gone has leaked
+    HeapStats heapStats = m_HeapAllocator.GetStats();
+    m_TopLevelLogger.Information("Engine heap peaked at {} bytes, {} block(s) ({} bytes) still allocated after unloading modules.",
+        heapStats.PeakAllocatedBytes, heapStats.AllocationCount, heapStats.AllocatedBytes);
+    m_MemoryTracker.ReportLeaks();
+
+    return result;
 }
 
 Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::BeginFrame() 
@@ -235,7 +271,7 @@ Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopC
     return m_GraphicsLayer.BeginFrame();
 }
 
-Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::Preupdate() 
+Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::Tick() 
 {
     // tick the timer
     m_WorldState.Tick();
@@ -243,6 +279,41 @@ Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopC
     // input handling
     m_InputManager.ProcessSdlEvents();
 
+    return CallbackSuccess();
+}
+
+CallbackResult GameLoop::GameLoopController::Simulate()
+{
+    while (m_WorldState.NextStep())
+    {
+        CallbackResult result = Preupdate();
+        if (result.has_value())
+            return result;
+
+        result = EventUpdate();
+        if (result.has_value())
+            return result;
+    }
+
+    return CallbackSuccess();
+}
+
+CallbackResult GameLoop::GameLoopController::SimulateTask(void* state)
+{
+    return static_cast<GameLoopController*>(state)->Simulate();
+}
+
+void GameLoop::GameLoopController::PrepareRenderState(bool takeSnapshot)
+{
+    auto rootModule = static_cast<RootModuleState*>(m_ModuleManager.FindModuleMutable(RootModuleState::GetDefinition().Name.Hash));
+    if (rootModule == nullptr)
+        return;
+
+    rootModule->PrepareRenderState(m_WorldState.GetInterpolationAlpha(), takeSnapshot);
+}
+
+Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::Preupdate() 
+{
     // pre-update
     for (InstancedSynchronousCallback callback : m_ModuleManager.m_PreupdateCallbacks) 
     {
@@ -257,7 +328,7 @@ Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopC
 Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::EventUpdate() 
 {
     // task-based event update
-    while (m_EventManager.ExecuteAllSystems(&m_Services, m_EventWriter)) 
+    while (m_EventManager.ExecuteAllSystems(&m_Services)) 
     {
         // mid-update events
         for (const InstancedSynchronousCallback &callback : m_ModuleManager.m_MidupdateCallbacks) 
@@ -265,23 +336,19 @@ Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopC
             callback.Callback(&m_Services, callback.InstanceState);
         }
 
+        // child tasks scheduled by the callbacks are tracked by the same counter
+        TaskCounter eventCallbacks;
         for (const InstancedEventCallback &routine : m_ModuleManager.m_EventCallbacks) 
         {
             Task task{TaskType::ProcessInputEvents};
-            task.Payload.ProcessInputEventsTask = {routine, &m_EventWriter, 1};
-            m_TaskManager.ScheduleWork(task);
+            task.Payload.ProcessInputEventsTask = {routine, m_EventManager.GetWriters(), m_EventManager.GetWriterCount()};
+            m_TaskManager.ScheduleWork(task, &eventCallbacks);
         }
 
-        size_t tasksLeft = m_ModuleManager.m_EventCallbacks.size();
-
-        while (tasksLeft > 0) 
-        {
-            TaskResult nextResult = m_TaskManager.WaitOne();
-            tasksLeft += nextResult.AdditionalTasks - 1;
-
-            if (nextResult.Result.has_value())
-                return nextResult.Result;
-        }
+        // the main thread works on the queued callbacks instead of idling
+        CallbackResult callbackResult = m_TaskManager.Join(&eventCallbacks);
+        if (callbackResult.has_value())
+            return callbackResult;
 
         // post-update events
         for (const InstancedSynchronousCallback &callback : m_ModuleManager.m_PostupdateCallbacks) 
@@ -311,7 +378,10 @@ Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopC
 Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::EndFrame() 
 {
     // last step in the update loop
-    return m_GraphicsLayer.EndFrame();
+    CallbackResult result = m_GraphicsLayer.EndFrame();
+    m_HeapAllocator.EndFrame();
+    m_MemoryTracker.EndFrame();
+    return result;
 }
 
 Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::LoadEntity(Pipeline::HashId entityId)
@@ -328,6 +398,5 @@ CallbackResult GameLoop::GameLoopController::ReloadAsset(Pipeline::HashId module
 
 Engine::Core::Runtime::CallbackResult Engine::Core::Runtime::GameLoop::GameLoopController::PollAsyncIoEvents() 
 {
-    m_AssetManager.PollEvents();
-    return CallbackSuccess();
+    return m_AssetManager.PollEvents();
 }
@@ -26,6 +26,12 @@ std::string WrapSdlError(const char* header)
 
 CallbackResult Engine::Core::Runtime::GraphicsLayer::InitializeSDL()
 {
+    if (m_Configs->Headless)
+    {
+        m_Logger.Information("Running headless, GPU commands are counted instead of issued.");
+        return CallbackSuccess();
+    }
+
 	// Create window
 	m_Window = SDL_CreateWindow("Foobar Game",  m_Configs->WindowWidth, m_Configs->WindowHeight, 0);
 	if (m_Window == nullptr)
@@ -85,6 +91,12 @@ CallbackResult Engine::Core::Runtime::GraphicsLayer::BeginFrame()
 {
     m_Logger.Verbose("Begin frame.");
 
+    if (m_Configs->Headless)
+    {
+        m_Counters.Frames++;
+        return CallbackSuccess();
+    }
+
     // create command buffer
     m_CommandBuffer = SDL_AcquireGPUCommandBuffer(m_GpuDevice);
     if (m_CommandBuffer == NULL)
@@ -124,6 +136,9 @@ CallbackResult Engine::Core::Runtime::GraphicsLayer::EndFrame()
 {
     m_Logger.Verbose("End frame.");
 
+    if (m_Configs->Headless)
+        return CallbackSuccess();
+
 	if (!SDL_SubmitGPUCommandBuffer(m_CommandBuffer))
     {
         const char errorMessage[] = "Failed to submit GPU command buffer.";
@@ -141,6 +156,13 @@ GraphicsLayer::GraphicsLayer(const Configuration::ConfigurationProvider* configs
 
 Engine::Core::Runtime::GraphicsLayer::~GraphicsLayer()
 {
+    if (m_Configs->Headless)
+    {
+        m_Logger.Information("Headless session recorded {} frame(s), {} render pass(es), {} draw call(s) ({} indices), {} upload(s) ({} bytes).",
+            m_Counters.Frames, m_Counters.RenderPasses, m_Counters.DrawCalls, m_Counters.Indices, m_Counters.Uploads, m_Counters.UploadedBytes);
+        return;
+    }
+
     // release auxilliary resources
     SDL_ReleaseGPUTexture(m_GpuDevice, m_DepthBuffer);
 
@@ -158,6 +180,12 @@ Engine::Core::Runtime::GraphicsLayer::~GraphicsLayer()
 
 SDL_GPURenderPass* GraphicsLayer::AddRenderPass() 
 {
+    if (m_Configs->Headless)
+    {
+        m_Counters.RenderPasses++;
+        return nullptr;
+    }
+
     if (m_SwapchainTexture == nullptr || m_CommandBuffer == nullptr)
         SE_THROW_GRAPHICS_EXCEPTION;
 
@@ -178,5 +206,8 @@ SDL_GPURenderPass* GraphicsLayer::AddRenderPass()
 
 void GraphicsLayer::CommitRenderPass(SDL_GPURenderPass* pass) 
 {
+    if (pass == nullptr)
+        return;
+
     SDL_EndGPURenderPass(pass);
 }
\ No newline at end of file
@@ -0,0 +1,535 @@
+#include "EngineCore/Runtime/heap_allocator.h"
+#include "SDL3/SDL_bits.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace Engine::Core::Runtime;
+
+namespace {
+
+constexpr size_t FreeFlag = 1;
+constexpr size_t PrevFreeFlag = 2;
+constexpr size_t SmallFlag = 4;
+constexpr size_t HugeFlag = 8;
+
+constexpr size_t HeaderSize = 16;
+
+// a free block has to fit its header, the free list links and the footer holding its size
+constexpr size_t MinBlockSize = 64;
+
+inline size_t AlignUp(size_t value)
+{
+    return (value + 15) & ~(size_t)15;
+}
+
+inline int LowestBit(uint32_t bits)
+{
+    return SDL_MostSignificantBitIndex32(bits & (~bits + 1));
+}
+
+}
+
+thread_local ThreadCache<HeapAllocator::ThreadHeap> HeapAllocator::s_CachedHeap;
+
+HeapAllocator::HeapAllocator(MemoryTracker* memoryTracker)
+    :m_MemoryTracker(memoryTracker),
+    m_HugeBytes(0),
+    m_HugeCount(0),
+    m_AllocatedBytes(0),
+    m_PeakAllocatedBytes(0)
+{
+}
+
+HeapAllocator::~HeapAllocator()
+{
+    for (auto& heap : m_Heaps)
+    {
+        for (void* pool : heap->Pools)
+        {
+            free(pool);
+        }
+    }
+}
+
+// 16 byte steps up to 128, four classes per power of two after that
+int HeapAllocator::SizeClassOf(size_t size)
+{
+    if (size <= 128)
+        return size == 0 ? 0 : (int)((size - 1) >> 4);
+
+    int log = SDL_MostSignificantBitIndex32((Uint32)(size - 1));
+    return 8 + (log - 7) * 4 + (int)(((size - 1) >> (log - 2)) & 3);
+}
+
+size_t HeapAllocator::SizeOfClass(int sizeClass)
+{
+    if (sizeClass < 8)
+        return (size_t)(sizeClass + 1) * 16;
+
+    int log = 7 + (sizeClass - 8) / 4;
+    return ((size_t)1 << log) + (size_t)((sizeClass - 8) % 4 + 1) * ((size_t)1 << (log - 2));
+}
+
+void HeapAllocator::MapSize(size_t size, int* outFl, int* outSl)
+{
+    int log = SDL_MostSignificantBitIndex32((Uint32)size);
+    *outFl = log - MinBlockLog2;
+    *outSl = (int)((size >> (log - SlLog2)) & (SlCount - 1));
+}
+
+HeapAllocator::ThreadHeap* HeapAllocator::GetThreadHeap()
+{
+    if (ThreadHeap* cached = s_CachedHeap.Find(m_CacheKey))
+        return cached;
+
+    std::thread::id thread = std::this_thread::get_id();
+    ThreadHeap* heap = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& existing : m_Heaps)
+        {
+            if (existing->Thread == thread)
+                heap = existing.get();
+        }
+
+        // heaps live as long as the allocator, blocks of a thread that's gone can still be freed into them
+        if (heap == nullptr)
+        {
+            m_Heaps.push_back(std::make_unique<ThreadHeap>());
+            heap = m_Heaps.back().get();
+            heap->Thread = thread;
+        }
+    }
+
+    s_CachedHeap.Store(m_CacheKey, heap);
+    return heap;
+}
+
+// only the owning thread writes its counters, shared atomics are touched once per batch
+void HeapAllocator::TrackUsage(ThreadHeap* heap, ptrdiff_t bytes, ptrdiff_t count)
+{
+    heap->AllocationCount.store(heap->AllocationCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+
+    ptrdiff_t unpublished = heap->UnpublishedBytes.load(std::memory_order_relaxed) + bytes;
+    if (unpublished > UsageBatchBytes || unpublished < -UsageBatchBytes)
+    {
+        PublishUsage(unpublished);
+        unpublished = 0;
+    }
+    heap->UnpublishedBytes.store(unpublished, std::memory_order_relaxed);
+}
+
+void HeapAllocator::PublishUsage(ptrdiff_t bytes)
+{
+    size_t allocated = m_AllocatedBytes.fetch_add((size_t)bytes, std::memory_order_relaxed) + (size_t)bytes;
+    size_t peak = m_PeakAllocatedBytes.load(std::memory_order_relaxed);
+    while (bytes > 0 && allocated > peak && !m_PeakAllocatedBytes.compare_exchange_weak(peak, allocated, std::memory_order_relaxed)) {}
+}
+
+void HeapAllocator::DrainRemoteFrees(ThreadHeap* heap)
+{
+    if (heap->RemoteFrees.load(std::memory_order_relaxed) == nullptr)
+        return;
+
+    BlockHeader* header = heap->RemoteFrees.exchange(nullptr, std::memory_order_acquire);
+    while (header != nullptr)
+    {
+        BlockHeader* next = *reinterpret_cast<BlockHeader**>(header + 1);
+        FreeLocal(heap, header);
+        header = next;
+    }
+}
+
+void HeapAllocator::FreeLocal(ThreadHeap* heap, BlockHeader* header)
+{
+    if (header->HasFlag(SmallFlag))
+        FreeSmall(heap, header);
+    else
+        FreeBlockLocal(heap, header);
+}
+
+void* HeapAllocator::AllocateSmall(ThreadHeap* heap, int sizeClass)
+{
+    SizeClassState& state = heap->Classes[sizeClass];
+    Span* span = state.Current;
+
+    // a full span is left alone, it joins the partial list once one of its blocks comes back
+    if (span == nullptr || (span->FreeList == nullptr && span->Bump + span->BlockStride > span->End))
+    {
+        span = state.Partial;
+        if (span != nullptr)
+        {
+            state.Partial = span->Next;
+            if (state.Partial != nullptr)
+                state.Partial->Previous = nullptr;
+            span->Partial = false;
+        }
+        else
+        {
+            BlockHeader* spanBlock = AllocateBlock(heap, SpanSize);
+            if (spanBlock == nullptr)
+                return nullptr;
+
+            span = reinterpret_cast<Span*>(spanBlock + 1);
+            span->Heap = heap;
+            span->SizeClass = sizeClass;
+            span->BlockStride = HeaderSize + SizeOfClass(sizeClass);
+            span->Used = 0;
+            span->FreeList = nullptr;
+            span->Bump = reinterpret_cast<unsigned char*>(span) + AlignUp(sizeof(Span));
+            span->End = reinterpret_cast<unsigned char*>(spanBlock) + spanBlock->GetSize();
+            span->Next = nullptr;
+            span->Previous = nullptr;
+            span->Partial = false;
+        }
+        state.Current = span;
+    }
+
+    BlockHeader* header;
+    if (span->FreeList != nullptr)
+    {
+        header = static_cast<BlockHeader*>(span->FreeList);
+        span->FreeList = *reinterpret_cast<void**>(header + 1);
+    }
+    else
+    {
+        header = reinterpret_cast<BlockHeader*>(span->Bump);
+        header->Owner = span;
+        header->Set(span->BlockStride | SmallFlag);
+        span->Bump += span->BlockStride;
+    }
+
+    span->Used++;
+    return header + 1;
+}
+
+void HeapAllocator::FreeSmall(ThreadHeap* heap, BlockHeader* header)
+{
+    Span* span = static_cast<Span*>(header->Owner);
+    *reinterpret_cast<void**>(header + 1) = span->FreeList;
+    span->FreeList = header;
+    span->Used--;
+
+    SizeClassState& state = heap->Classes[span->SizeClass];
+    if (span == state.Current)
+        return;
+
+    if (span->Used == 0)
+    {
+        if (span->Partial)
+        {
+            if (span->Previous != nullptr)
+                span->Previous->Next = span->Next;
+            else
+                state.Partial = span->Next;
+            if (span->Next != nullptr)
+                span->Next->Previous = span->Previous;
+        }
+
+        FreeBlockLocal(heap, reinterpret_cast<BlockHeader*>(span) - 1);
+        return;
+    }
+
+    if (!span->Partial)
+    {
+        span->Previous = nullptr;
+        span->Next = state.Partial;
+        if (state.Partial != nullptr)
+            state.Partial->Previous = span;
+        state.Partial = span;
+        span->Partial = true;
+    }
+}
+
+void HeapAllocator::InsertFreeBlock(ThreadHeap* heap, FreeBlock* block)
+{
+    int fl, sl;
+    MapSize(block->Header.GetSize(), &fl, &sl);
+
+    block->Previous = nullptr;
+    block->Next = heap->FreeLists[fl][sl];
+    if (block->Next != nullptr)
+        block->Next->Previous = block;
+    heap->FreeLists[fl][sl] = block;
+
+    heap->FlBitmap |= 1u << fl;
+    heap->SlBitmap[fl] |= 1u << sl;
+}
+
+void HeapAllocator::RemoveFreeBlock(ThreadHeap* heap, FreeBlock* block)
+{
+    int fl, sl;
+    MapSize(block->Header.GetSize(), &fl, &sl);
+
+    if (block->Next != nullptr)
+        block->Next->Previous = block->Previous;
+    if (block->Previous != nullptr)
+    {
+        block->Previous->Next = block->Next;
+        return;
+    }
+
+    heap->FreeLists[fl][sl] = block->Next;
+    if (block->Next == nullptr)
+    {
+        heap->SlBitmap[fl] &= ~(1u << sl);
+        if (heap->SlBitmap[fl] == 0)
+            heap->FlBitmap &= ~(1u << fl);
+    }
+}
+
+bool HeapAllocator::AddPool(ThreadHeap* heap)
+{
+    unsigned char* pool = static_cast<unsigned char*>(malloc(PoolSize));
+    if (pool == nullptr)
+        return false;
+
+    heap->Pools.push_back(pool);
+    heap->ReservedBytes.fetch_add(PoolSize, std::memory_order_relaxed);
+
+    // one free block spanning the pool, and a used block of size zero at the end so merging stops there
+    size_t size = PoolSize - HeaderSize;
+    BlockHeader* block = reinterpret_cast<BlockHeader*>(pool);
+    block->Owner = heap;
+    block->Set(size | FreeFlag);
+    *reinterpret_cast<size_t*>(pool + size - sizeof(size_t)) = size;
+
+    BlockHeader* sentinel = reinterpret_cast<BlockHeader*>(pool + size);
+    sentinel->Owner = heap;
+    sentinel->Set(PrevFreeFlag);
+
+    InsertFreeBlock(heap, reinterpret_cast<FreeBlock*>(block));
+    return true;
+}
+
+HeapAllocator::BlockHeader* HeapAllocator::AllocateBlock(ThreadHeap* heap, size_t blockSize)
+{
+    // rounding up to the next list means any block found there fits, no list has to be searched
+    size_t rounded = blockSize + ((size_t)1 << (SDL_MostSignificantBitIndex32((Uint32)blockSize) - SlLog2)) - 1;
+    int fl, sl;
+    MapSize(rounded, &fl, &sl);
+
+    FreeBlock* found = nullptr;
+    for (int attempt = 0; attempt < 2 && found == nullptr; attempt++)
+    {
+        uint32_t slMap = heap->SlBitmap[fl] & (~0u << sl);
+        int foundFl = fl;
+        if (slMap == 0)
+        {
+            uint32_t flMap = heap->FlBitmap & (~0u << (fl + 1));
+            if (flMap != 0)
+            {
+                foundFl = LowestBit(flMap);
+                slMap = heap->SlBitmap[foundFl];
+            }
+        }
+
+        if (slMap != 0)
+            found = heap->FreeLists[foundFl][LowestBit(slMap)];
+        else if (attempt == 0 && !AddPool(heap))
+            return nullptr;
+    }
+
+    if (found == nullptr)
+        return nullptr;
+
+    RemoveFreeBlock(heap, found);
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(found);
+    size_t size = header->GetSize();
+
+    if (size - blockSize >= MinBlockSize)
+    {
+        // the rest goes back to the free lists, the block after it still has a free block in front
+        size_t restSize = size - blockSize;
+        unsigned char* rest = reinterpret_cast<unsigned char*>(header) + blockSize;
+        reinterpret_cast<BlockHeader*>(rest)->Set(restSize | FreeFlag);
+        *reinterpret_cast<size_t*>(rest + restSize - sizeof(size_t)) = restSize;
+        InsertFreeBlock(heap, reinterpret_cast<FreeBlock*>(rest));
+        size = blockSize;
+    }
+    else
+    {
+        BlockHeader* next = reinterpret_cast<BlockHeader*>(reinterpret_cast<unsigned char*>(header) + size);
+        next->Set(next->SizeAndFlags.load(std::memory_order_relaxed) & ~PrevFreeFlag);
+    }
+
+    header->Owner = heap;
+    header->Set(size);
+    return header;
+}
+
+void HeapAllocator::FreeBlockLocal(ThreadHeap* heap, BlockHeader* header)
+{
+    size_t size = header->GetSize();
+
+    BlockHeader* next = reinterpret_cast<BlockHeader*>(reinterpret_cast<unsigned char*>(header) + size);
+    if (next->HasFlag(FreeFlag))
+    {
+        RemoveFreeBlock(heap, reinterpret_cast<FreeBlock*>(next));
+        size += next->GetSize();
+    }
+
+    if (header->HasFlag(PrevFreeFlag))
+    {
+        size_t previousSize = *(reinterpret_cast<size_t*>(header) - 1);
+        header = reinterpret_cast<BlockHeader*>(reinterpret_cast<unsigned char*>(header) - previousSize);
+        RemoveFreeBlock(heap, reinterpret_cast<FreeBlock*>(header));
+        size += previousSize;
+    }
+
+    // free blocks are never next to each other, so the one in front of this is in use
+    unsigned char* block = reinterpret_cast<unsigned char*>(header);
+    header->Set(size | FreeFlag);
+    *reinterpret_cast<size_t*>(block + size - sizeof(size_t)) = size;
+    next = reinterpret_cast<BlockHeader*>(block + size);
+    next->Set(next->SizeAndFlags.load(std::memory_order_relaxed) | PrevFreeFlag);
+    InsertFreeBlock(heap, reinterpret_cast<FreeBlock*>(header));
+}
+
+void* HeapAllocator::Allocate(size_t size, MemoryOwner owner, MemorySubsystem subsystem)
+{
+    if (owner >= MemoryTracker::MaxOwners)
+        owner = EngineMemoryOwner;
+    size_t tags = ((size_t)owner << MemoryOwnerShift) | ((size_t)subsystem << MemorySubsystemShift);
+
+    if (size > HugeBlockThreshold)
+    {
+        size_t blockSize = AlignUp(size) + HeaderSize;
+        BlockHeader* header = static_cast<BlockHeader*>(malloc(blockSize));
+        if (header == nullptr)
+            return nullptr;
+
+        header->Owner = nullptr;
+        header->Set(blockSize | HugeFlag | tags);
+        m_HugeBytes.fetch_add(blockSize, std::memory_order_relaxed);
+        m_HugeCount.fetch_add(1, std::memory_order_relaxed);
+        PublishUsage((ptrdiff_t)blockSize);
+        m_MemoryTracker->TrackAllocation(subsystem, owner, blockSize);
+        return header + 1;
+    }
+
+    ThreadHeap* heap = GetThreadHeap();
+    DrainRemoteFrees(heap);
+
+    BlockHeader* header;
+    if (size <= SmallBlockLimit)
+    {
+        void* block = AllocateSmall(heap, SizeClassOf(size));
+        header = block != nullptr ? static_cast<BlockHeader*>(block) - 1 : nullptr;
+    }
+    else
+    {
+        header = AllocateBlock(heap, AlignUp(size) + HeaderSize);
+    }
+
+    if (header == nullptr)
+        return nullptr;
+
+    // small blocks come back from their span's free list still tagged for whoever had them before
+    size_t sizeAndFlags = header->SizeAndFlags.load(std::memory_order_relaxed);
+    header->Set((sizeAndFlags & ~(~(size_t)0 << MemoryOwnerShift)) | tags);
+
+    size_t blockSize = sizeAndFlags & SizeMask;
+    TrackUsage(heap, (ptrdiff_t)blockSize, 1);
+    m_MemoryTracker->TrackAllocation(subsystem, owner, blockSize);
+    return header + 1;
+}
+
+void HeapAllocator::Deallocate(void* buffer)
+{
+    if (buffer == nullptr)
+        return;
+
+    BlockHeader* header = static_cast<BlockHeader*>(buffer) - 1;
+    size_t size = header->GetSize();
+    m_MemoryTracker->TrackFree(header->GetMemorySubsystem(), header->GetMemoryOwner(), size);
+    if (header->HasFlag(HugeFlag))
+    {
+        m_HugeBytes.fetch_sub(size, std::memory_order_relaxed);
+        m_HugeCount.fetch_sub(1, std::memory_order_relaxed);
+        PublishUsage(-(ptrdiff_t)size);
+        free(header);
+        return;
+    }
+
+    ThreadHeap* owner = header->HasFlag(SmallFlag)
+        ? static_cast<Span*>(header->Owner)->Heap
+        : static_cast<ThreadHeap*>(header->Owner);
+    ThreadHeap* heap = GetThreadHeap();
+    TrackUsage(heap, -(ptrdiff_t)size, -1);
+
+    if (heap == owner)
+    {
+        FreeLocal(owner, header);
+        DrainRemoteFrees(owner);
+        return;
+    }
+
+    // the owner puts it back the next time it allocates, frees or ends a frame
+    BlockHeader* head = owner->RemoteFrees.load(std::memory_order_relaxed);
+    do
+    {
+        *reinterpret_cast<BlockHeader**>(header + 1) = head;
+    } while (!owner->RemoteFrees.compare_exchange_weak(head, header, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void* HeapAllocator::Realloc(void* buffer, size_t newSize)
+{
+    if (buffer == nullptr)
+        return Allocate(newSize);
+
+    if (newSize == 0)
+    {
+        Deallocate(buffer);
+        return nullptr;
+    }
+
+    size_t usableSize = GetUsableSize(buffer);
+    if (newSize <= usableSize)
+        return buffer;
+
+    BlockHeader* header = static_cast<BlockHeader*>(buffer) - 1;
+    void* moved = Allocate(newSize, header->GetMemoryOwner(), header->GetMemorySubsystem());
+    if (moved == nullptr)
+        return nullptr;
+
+    memcpy(moved, buffer, usableSize);
+    Deallocate(buffer);
+    return moved;
+}
+
+size_t HeapAllocator::GetUsableSize(const void* buffer) const
+{
+    const BlockHeader* header = static_cast<const BlockHeader*>(buffer) - 1;
+    return header->GetSize() - HeaderSize;
+}
+
+void HeapAllocator::EndFrame()
+{
+    DrainRemoteFrees(GetThreadHeap());
+}
+
+HeapStats HeapAllocator::GetStats()
+{
+    // the caller's heap takes back what other threads freed into it, the same as at the end of a frame
+    DrainRemoteFrees(GetThreadHeap());
+
+    HeapStats stats {};
+    stats.AllocatedBytes = m_AllocatedBytes.load(std::memory_order_relaxed);
+    stats.PeakAllocatedBytes = m_PeakAllocatedBytes.load(std::memory_order_relaxed);
+    stats.ReservedBytes = m_HugeBytes.load(std::memory_order_relaxed);
+
+    ptrdiff_t allocationCount = (ptrdiff_t)m_HugeCount.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (auto& heap : m_Heaps)
+    {
+        allocationCount += heap->AllocationCount.load(std::memory_order_relaxed);
+        stats.AllocatedBytes += (size_t)heap->UnpublishedBytes.load(std::memory_order_relaxed);
+        stats.ReservedBytes += heap->ReservedBytes.load(std::memory_order_relaxed);
+    }
+    stats.AllocationCount = allocationCount > 0 ? (size_t)allocationCount : 0;
+    stats.FragmentedBytes = stats.ReservedBytes > stats.AllocatedBytes ? stats.ReservedBytes - stats.AllocatedBytes : 0;
+    stats.ThreadHeapCount = m_Heaps.size();
+
+    return stats;
+}
@@ -0,0 +1,403 @@
+#ifdef __linux__
+
+#include "EngineCore/AssetManagement/io_uring_asset_io_backend.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+using namespace Engine::Core::AssetManagement;
+
+// the kernel caps a single read at this many bytes, larger ones would come back short
+static constexpr size_t MaxReadSize = 0x7FFFF000;
+
+// a registered buffer can't be larger than this
+static constexpr size_t MaxRegisteredBufferSize = 1024 * 1024 * 1024;
+
+enum RequestStage : unsigned long long
+{
+    OpenStage,
+    ReadStage,
+    CloseStage
+};
+
+static int RingSetup(unsigned entries, io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int RingEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+static int RingRegister(int ringFd, unsigned opcode, void* argument, unsigned argumentCount)
+{
+    return (int)syscall(__NR_io_uring_register, ringFd, opcode, argument, argumentCount);
+}
+
+IoUringAssetIoBackend::IoUringAssetIoBackend()
+    : m_RingFd(-1),
+      m_SqRing(MAP_FAILED),
+      m_SqRingSize(0),
+      m_CqRing(MAP_FAILED),
+      m_CqRingSize(0),
+      m_Sqes((io_uring_sqe*)MAP_FAILED),
+      m_SqesSize(0),
+      m_SqHead(nullptr),
+      m_SqTail(nullptr),
+      m_SqArray(nullptr),
+      m_SqMask(0),
+      m_SqEntries(0),
+      m_CqHead(nullptr),
+      m_CqTail(nullptr),
+      m_CqMask(0),
+      m_Cqes(nullptr),
+      m_SqLocalTail(0),
+      m_Unsubmitted(0),
+      m_RequestsInFlight(0)
+{
+}
+
+IoUringAssetIoBackend::~IoUringAssetIoBackend()
+{
+    // the kernel still writes into the destination buffers of requests in flight, wait for them
+    if (m_RingFd >= 0)
+    {
+        Submit();
+        while (m_RequestsInFlight > 0)
+        {
+            Reap();
+            if (m_RequestsInFlight > 0 && RingEnter(m_RingFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                break;
+        }
+    }
+
+    if (m_Sqes != MAP_FAILED)
+        munmap(m_Sqes, m_SqesSize);
+    if (m_CqRing != MAP_FAILED && m_CqRing != m_SqRing)
+        munmap(m_CqRing, m_CqRingSize);
+    if (m_SqRing != MAP_FAILED)
+        munmap(m_SqRing, m_SqRingSize);
+    if (m_RingFd >= 0)
+        close(m_RingFd);
+}
+
+bool IoUringAssetIoBackend::Initialize(unsigned int queueDepth)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    m_RingFd = RingSetup(std::max(queueDepth, 3u), &params);
+    if (m_RingFd < 0)
+        return false;
+
+    m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_SqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+        m_CqRingSize = m_SqRingSize;
+    }
+
+    m_SqRing = mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+    if (m_SqRing == MAP_FAILED)
+        return false;
+
+    m_CqRing = params.features & IORING_FEAT_SINGLE_MMAP
+        ? m_SqRing
+        : mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+    if (m_CqRing == MAP_FAILED)
+        return false;
+
+    m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    m_Sqes = (io_uring_sqe*)mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES);
+    if (m_Sqes == MAP_FAILED)
+        return false;
+
+    unsigned char* sqRing = static_cast<unsigned char*>(m_SqRing);
+    m_SqHead = (unsigned*)(sqRing + params.sq_off.head);
+    m_SqTail = (unsigned*)(sqRing + params.sq_off.tail);
+    m_SqArray = (unsigned*)(sqRing + params.sq_off.array);
+    m_SqMask = *(unsigned*)(sqRing + params.sq_off.ring_mask);
+    m_SqEntries = params.sq_entries;
+    m_SqLocalTail = *m_SqTail;
+
+    unsigned char* cqRing = static_cast<unsigned char*>(m_CqRing);
+    m_CqHead = (unsigned*)(cqRing + params.cq_off.head);
+    m_CqTail = (unsigned*)(cqRing + params.cq_off.tail);
+    m_CqMask = *(unsigned*)(cqRing + params.cq_off.ring_mask);
+    m_Cqes = (io_uring_cqe*)(cqRing + params.cq_off.cqes);
+
+    // one direct descriptor per request, a request needs three submissions and three completions
+    size_t requestCount = m_SqEntries / 3;
+    io_uring_rsrc_register files;
+    memset(&files, 0, sizeof(files));
+    files.nr = (unsigned)requestCount;
+    files.flags = IORING_RSRC_REGISTER_SPARSE;
+    if (RingRegister(m_RingFd, IORING_REGISTER_FILES2, &files, sizeof(files)) < 0)
+        return false;
+
+    m_Requests.resize(requestCount);
+    for (size_t i = requestCount; i > 0; i--)
+    {
+        m_FreeRequests.push_back((int)i - 1);
+    }
+
+    // fixed buffers are an optimization, the backend works without them
+    io_uring_rsrc_register buffers;
+    memset(&buffers, 0, sizeof(buffers));
+    buffers.nr = MaxRegisteredBuffers;
+    buffers.flags = IORING_RSRC_REGISTER_SPARSE;
+    if (RingRegister(m_RingFd, IORING_REGISTER_BUFFERS2, &buffers, sizeof(buffers)) >= 0)
+        m_Buffers.resize(MaxRegisteredBuffers);
+
+    return true;
+}
+
+io_uring_sqe* IoUringAssetIoBackend::NextSqe()
+{
+    unsigned head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE);
+    if (m_SqLocalTail - head >= m_SqEntries)
+        return nullptr;
+
+    unsigned index = m_SqLocalTail & m_SqMask;
+    io_uring_sqe* sqe = &m_Sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    m_SqArray[index] = index;
+    m_SqLocalTail++;
+    m_Unsubmitted++;
+    return sqe;
+}
+
+void IoUringAssetIoBackend::StartRequest(PendingRead& read)
+{
+    int slot = m_FreeRequests.back();
+    m_FreeRequests.pop_back();
+    m_RequestsInFlight++;
+
+    Request& request = m_Requests[slot];
+    request.Path = std::move(read.Path);
+    request.UserData = read.UserData;
+    request.Size = read.Size;
+    request.OpenResult = 0;
+    request.ReadResult = 0;
+    request.BufferSlot = read.BufferSlot;
+    request.PendingCompletions = 3;
+
+    // the path is copied by the kernel when the batch is submitted, the request keeps it alive until then; direct
+    // descriptors never reach the file table, O_CLOEXEC is rejected for them
+    io_uring_sqe* open = NextSqe();
+    open->opcode = IORING_OP_OPENAT;
+    open->fd = AT_FDCWD;
+    open->addr = (unsigned long long)request.Path.c_str();
+    open->open_flags = O_RDONLY;
+    open->file_index = slot + 1;
+    open->flags = IOSQE_IO_LINK;
+    open->user_data = ((unsigned long long)slot << 2) | OpenStage;
+
+    io_uring_sqe* readSqe = NextSqe();
+    readSqe->opcode = request.BufferSlot >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+    readSqe->fd = slot;
+    readSqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+    readSqe->addr = (unsigned long long)read.Destination;
+    readSqe->len = (unsigned)read.Size;
+    readSqe->off = read.Offset;
+    readSqe->buf_index = request.BufferSlot >= 0 ? (unsigned short)request.BufferSlot : 0;
+    readSqe->user_data = ((unsigned long long)slot << 2) | ReadStage;
+
+    // a failed open or short read cancels the close, the slot is simply replaced by the next open into it
+    io_uring_sqe* closeSqe = NextSqe();
+    closeSqe->opcode = IORING_OP_CLOSE;
+    closeSqe->file_index = slot + 1;
+    closeSqe->user_data = ((unsigned long long)slot << 2) | CloseStage;
+}
+
+bool IoUringAssetIoBackend::QueueRead(const char* path, void* destination, size_t offset, size_t size, void* userData)
+{
+    if (size > MaxReadSize)
+    {
+        errno = EFBIG;
+        return false;
+    }
+
+    // the buffer is picked now, it may be unregistered before the request makes it into the ring
+    int bufferSlot = -1;
+    unsigned char* target = static_cast<unsigned char*>(destination);
+    for (size_t i = 0; i < m_Buffers.size(); i++)
+    {
+        RegisteredBuffer& buffer = m_Buffers[i];
+        if (!buffer.Retired && buffer.Base != nullptr && target >= buffer.Base && target + size <= buffer.Base + buffer.Size)
+        {
+            bufferSlot = (int)i;
+            buffer.PendingReads++;
+            break;
+        }
+    }
+
+    // requests are only written to the ring on submit, that's when the free slots are known
+    m_Backlog.push_back({ path, destination, offset, size, userData, bufferSlot });
+    return true;
+}
+
+void IoUringAssetIoBackend::Submit()
+{
+    unsigned head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE);
+    while (!m_Backlog.empty() && !m_FreeRequests.empty() && m_SqEntries - (m_SqLocalTail - head) >= 3)
+    {
+        StartRequest(m_Backlog.front());
+        m_Backlog.pop_front();
+    }
+
+    if (m_Unsubmitted == 0)
+        return;
+
+    // one syscall for the whole batch; anything the kernel didn't take now goes with the next submit
+    __atomic_store_n(m_SqTail, m_SqLocalTail, __ATOMIC_RELEASE);
+    int submitted = RingEnter(m_RingFd, m_Unsubmitted, 0, 0);
+    if (submitted > 0)
+        m_Unsubmitted -= (unsigned)submitted;
+}
+
+void IoUringAssetIoBackend::Reap()
+{
+    unsigned head = *m_CqHead;
+    unsigned tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+
+    while (head != tail)
+    {
+        const io_uring_cqe& cqe = m_Cqes[head & m_CqMask];
+        int slot = (int)(cqe.user_data >> 2);
+        Request& request = m_Requests[slot];
+
+        switch (cqe.user_data & 3)
+        {
+        case OpenStage:
+            request.OpenResult = cqe.res;
+            break;
+        case ReadStage:
+            request.ReadResult = cqe.res;
+            break;
+        default:
+            break;
+        }
+
+        if (--request.PendingCompletions == 0)
+            FinishRequest(slot);
+        head++;
+    }
+
+    __atomic_store_n(m_CqHead, head, __ATOMIC_RELEASE);
+}
+
+void IoUringAssetIoBackend::FinishRequest(int slot)
+{
+    Request& request = m_Requests[slot];
+
+    AssetIoCompletion completion { request.UserData, AssetIoStatus::Complete, "" };
+    if (request.OpenResult < 0)
+    {
+        completion.Status = AssetIoStatus::Failure;
+        completion.ErrorDetail = strerror(-request.OpenResult);
+    }
+    else if (request.ReadResult == -ECANCELED)
+    {
+        completion.Status = AssetIoStatus::Canceled;
+    }
+    else if (request.ReadResult < 0)
+    {
+        completion.Status = AssetIoStatus::Failure;
+        completion.ErrorDetail = strerror(-request.ReadResult);
+    }
+    else if ((size_t)request.ReadResult != request.Size)
+    {
+        completion.Status = AssetIoStatus::Failure;
+        completion.ErrorDetail = "file is shorter than expected";
+    }
+    m_Ready.push_back(completion);
+
+    if (request.BufferSlot >= 0)
+    {
+        RegisteredBuffer& buffer = m_Buffers[request.BufferSlot];
+        buffer.PendingReads--;
+        if (buffer.Retired && buffer.PendingReads == 0)
+            UpdateBufferSlot(request.BufferSlot, nullptr, 0);
+    }
+
+    request.Path.clear();
+    m_FreeRequests.push_back(slot);
+    m_RequestsInFlight--;
+}
+
+bool IoUringAssetIoBackend::GetCompletion(AssetIoCompletion* outCompletion)
+{
+    if (m_Ready.empty())
+        Reap();
+
+    if (m_Ready.empty())
+        return false;
+
+    *outCompletion = m_Ready.front();
+    m_Ready.pop_front();
+    return true;
+}
+
+bool IoUringAssetIoBackend::UpdateBufferSlot(int slot, void* base, size_t size)
+{
+    iovec vector { base, size };
+    io_uring_rsrc_update2 update;
+    memset(&update, 0, sizeof(update));
+    update.offset = (unsigned)slot;
+    update.data = (unsigned long long)&vector;
+    update.nr = 1;
+
+    bool updated = RingRegister(m_RingFd, IORING_REGISTER_BUFFERS_UPDATE, &update, sizeof(update)) >= 0;
+
+    // a slot that fails to clear is given up, it can't be trusted to point anywhere sensible
+    RegisteredBuffer& buffer = m_Buffers[slot];
+    buffer.Base = updated ? static_cast<unsigned char*>(base) : nullptr;
+    buffer.Size = updated ? size : 0;
+    buffer.PendingReads = 0;
+    buffer.Retired = !updated && base == nullptr;
+    return updated;
+}
+
+void IoUringAssetIoBackend::RegisterBuffer(void* base, size_t size)
+{
+    if (base == nullptr || size == 0 || size > MaxRegisteredBufferSize)
+        return;
+
+    // out of slots or over the locked memory limit, reads into the buffer just take the regular path
+    for (size_t i = 0; i < m_Buffers.size(); i++)
+    {
+        if (m_Buffers[i].Base == nullptr && !m_Buffers[i].Retired)
+        {
+            UpdateBufferSlot((int)i, base, size);
+            return;
+        }
+    }
+}
+
+void IoUringAssetIoBackend::UnregisterBuffer(void* base)
+{
+    for (size_t i = 0; i < m_Buffers.size(); i++)
+    {
+        RegisteredBuffer& buffer = m_Buffers[i];
+        if (buffer.Base != base || buffer.Retired)
+            continue;
+
+        // reads queued into it keep it registered until they're done
+        buffer.Retired = true;
+        if (buffer.PendingReads == 0)
+            UpdateBufferSlot((int)i, nullptr, 0);
+        return;
+    }
+}
+
+#endif
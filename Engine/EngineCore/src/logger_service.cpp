@@ -121,5 +121,10 @@ LoggerService::LoggerService(Engine::Core::Configuration::ConfigurationProvider
 
 Logger LoggerService::CreateLogger(const char* channel)
 {
+    // channels are registered globally in spdlog, reuse them when another service instance asks for the same name
+    std::shared_ptr<spdlog::logger> existing = spdlog::get(channel);
+    if (existing != nullptr)
+        return Logger(existing);
+
     return Logger(spdlog::stdout_color_mt(channel));
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "EngineCore/Runtime/memory_tracker.h"
+#include "EngineCore/Logging/logger_service.h"
+#include <cstring>
+
+using namespace Engine::Core::Runtime;
+
+static const char* SubsystemNames[MemorySubsystemCount] = { "transient buffers", "engine heap", "containers", "GPU buffers", "scripting" };
+
+thread_local ThreadCache<MemoryTracker::ThreadCounters> MemoryTracker::s_CachedCounters;
+
+MemoryTracker::MemoryTracker(const Configuration::ConfigurationProvider* configs, Logging::LoggerService* loggerService)
+    :m_Logger(loggerService->CreateLogger("MemoryTracker")),
+    m_Budgets {
+        configs->TransientMemoryBudget,
+        configs->HeapMemoryBudget,
+        configs->ContainerMemoryBudget,
+        configs->GpuMemoryBudget,
+        configs->ScriptingMemoryBudget
+    },
+    m_OverBudget {},
+    m_Usage {},
+    m_SubsystemUsage {}
+{
+    m_OwnerNames.push_back("Engine");
+}
+
+MemoryTracker::ThreadCounters* MemoryTracker::GetThreadCounters()
+{
+    if (ThreadCounters* cached = s_CachedCounters.Find(m_CacheKey))
+        return cached;
+
+    std::thread::id thread = std::this_thread::get_id();
+    ThreadCounters* counters = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& existing : m_Threads)
+        {
+            if (existing->Thread == thread)
+                counters = existing.get();
+        }
+
+        if (counters == nullptr)
+        {
+            m_Threads.push_back(std::make_unique<ThreadCounters>());
+            counters = m_Threads.back().get();
+            counters->Thread = thread;
+        }
+    }
+
+    s_CachedCounters.Store(m_CacheKey, counters);
+    return counters;
+}
+
+MemoryOwner MemoryTracker::RegisterOwner(const char* name)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (size_t i = 0; i < m_OwnerNames.size(); i++)
+    {
+        if (m_OwnerNames[i] == name)
+            return (MemoryOwner)i;
+    }
+
+    if (m_OwnerNames.size() == MaxOwners)
+    {
+        m_Logger.Warning("Out of memory owners, allocations of {} are counted as the engine's.", name);
+        return EngineMemoryOwner;
+    }
+
+    m_OwnerNames.push_back(name);
+    return (MemoryOwner)(m_OwnerNames.size() - 1);
+}
+
+const char* MemoryTracker::GetOwnerName(MemoryOwner owner)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return owner < m_OwnerNames.size() ? m_OwnerNames[owner].c_str() : m_OwnerNames[EngineMemoryOwner].c_str();
+}
+
+void MemoryTracker::EndFrame()
+{
+    Snapshot totals[MemorySubsystemCount][MaxOwners] {};
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& thread : m_Threads)
+        {
+            for (int subsystem = 0; subsystem < MemorySubsystemCount; subsystem++)
+            {
+                for (MemoryOwner owner = 0; owner < MaxOwners; owner++)
+                {
+                    const Counters& counters = thread->Owners[subsystem][owner];
+                    Snapshot& total = totals[subsystem][owner];
+                    total.Allocations += counters.Allocations.load(std::memory_order_relaxed);
+                    total.Frees += counters.Frees.load(std::memory_order_relaxed);
+                    total.AllocatedBytes += counters.AllocatedBytes.load(std::memory_order_relaxed);
+                    total.FreedBytes += counters.FreedBytes.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    for (int subsystem = 0; subsystem < MemorySubsystemCount; subsystem++)
+    {
+        MemoryUsage& subsystemUsage = m_SubsystemUsage[subsystem];
+        size_t subsystemPeak = subsystemUsage.PeakBytes;
+        subsystemUsage = {};
+
+        for (MemoryOwner owner = 0; owner < MaxOwners; owner++)
+        {
+            const Snapshot& total = totals[subsystem][owner];
+            const Snapshot& previous = m_Totals[subsystem][owner];
+            MemoryUsage& usage = m_Usage[subsystem][owner];
+
+            // a free counted on another thread may be gathered before its allocation, live usage never goes below zero
+            usage.LiveBytes = total.AllocatedBytes > total.FreedBytes ? total.AllocatedBytes - total.FreedBytes : 0;
+            usage.LiveCount = total.Allocations > total.Frees ? total.Allocations - total.Frees : 0;
+            usage.PeakBytes = usage.LiveBytes > usage.PeakBytes ? usage.LiveBytes : usage.PeakBytes;
+            usage.FrameAllocations = total.Allocations - previous.Allocations;
+            usage.FrameFrees = total.Frees - previous.Frees;
+            usage.FrameAllocatedBytes = total.AllocatedBytes - previous.AllocatedBytes;
+
+            subsystemUsage.LiveBytes += usage.LiveBytes;
+            subsystemUsage.LiveCount += usage.LiveCount;
+            subsystemUsage.FrameAllocations += usage.FrameAllocations;
+            subsystemUsage.FrameFrees += usage.FrameFrees;
+            subsystemUsage.FrameAllocatedBytes += usage.FrameAllocatedBytes;
+        }
+        subsystemUsage.PeakBytes = subsystemUsage.LiveBytes > subsystemPeak ? subsystemUsage.LiveBytes : subsystemPeak;
+
+        // alarms only fire when the budget is crossed, not every frame the subsystem stays beyond it
+        size_t budget = m_Budgets[subsystem];
+        bool overBudget = budget > 0 && subsystemUsage.LiveBytes > budget;
+        if (overBudget && !m_OverBudget[subsystem])
+        {
+            m_Logger.Warning("Memory budget of {} exceeded: {} bytes in {} allocation(s), budget is {} bytes.",
+                SubsystemNames[subsystem], subsystemUsage.LiveBytes, subsystemUsage.LiveCount, budget);
+        }
+        else if (!overBudget && m_OverBudget[subsystem])
+        {
+            m_Logger.Information("Memory of {} back within budget: {} bytes.", SubsystemNames[subsystem], subsystemUsage.LiveBytes);
+        }
+        m_OverBudget[subsystem] = overBudget;
+    }
+
+    memcpy(m_Totals, totals, sizeof(m_Totals));
+}
+
+MemoryUsage MemoryTracker::GetUsage(MemorySubsystem subsystem, MemoryOwner owner) const
+{
+    return m_Usage[(int)subsystem][owner < MaxOwners ? owner : EngineMemoryOwner];
+}
+
+MemoryUsage MemoryTracker::GetSubsystemUsage(MemorySubsystem subsystem) const
+{
+    return m_SubsystemUsage[(int)subsystem];
+}
+
+size_t MemoryTracker::ReportLeaks()
+{
+    EndFrame();
+
+    size_t leakCount = 0;
+    for (int subsystem = 0; subsystem < MemorySubsystemCount; subsystem++)
+    {
+        for (MemoryOwner owner = 0; owner < MaxOwners; owner++)
+        {
+            const MemoryUsage& usage = m_Usage[subsystem][owner];
+            if (usage.LiveCount == 0)
+                continue;
+
+            m_Logger.Warning("{} still holds {} allocation(s) of {} bytes in {} (peaked at {} bytes).",
+                GetOwnerName(owner), usage.LiveCount, usage.LiveBytes, SubsystemNames[subsystem], usage.PeakBytes);
+            leakCount += usage.LiveCount;
+        }
+    }
+
+    return leakCount;
+}
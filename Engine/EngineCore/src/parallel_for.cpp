@@ -0,0 +1,56 @@
+#include "EngineCore/Runtime/parallel_for.h"
+#include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/task_scheduler.h"
+
+using namespace Engine::Core::Runtime;
+
+struct ParallelForContext
+{
+    ParallelForDelegate Routine;
+    void* State;
+    size_t Begin;
+    size_t End;
+    size_t GrainSize;
+    std::atomic<size_t> NextChunk;
+    std::atomic<bool> Failed;
+};
+
+static CallbackResult ParallelForRunner(void* state, size_t runnerIndex)
+{
+    auto context = (ParallelForContext*)state;
+
+    // stop claiming once any runner failed, the error is collected by the join
+    while (!context->Failed.load(std::memory_order_relaxed))
+    {
+        size_t chunkBegin = context->Begin + context->NextChunk.fetch_add(1, std::memory_order_relaxed) * context->GrainSize;
+        if (chunkBegin >= context->End)
+            break;
+
+        size_t chunkEnd = std::min(chunkBegin + context->GrainSize, context->End);
+        CallbackResult result = context->Routine(context->State, chunkBegin, chunkEnd);
+        if (result.has_value())
+        {
+            context->Failed.store(true, std::memory_order_relaxed);
+            return result;
+        }
+    }
+
+    return CallbackSuccess();
+}
+
+CallbackResult Engine::Core::Runtime::ParallelFor(ITaskScheduler* scheduler, size_t begin, size_t end, size_t grainSize, ParallelForDelegate routine, void* state)
+{
+    if (end <= begin)
+        return CallbackSuccess();
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+    // never wake more runners than there are chunks to hand out
+    size_t runnerCount = std::min(chunkCount, scheduler->GetConcurrency());
+    if (runnerCount <= 1)
+        return routine(state, begin, end);
+
+    ParallelForContext context { routine, state, begin, end, grainSize, { 0 }, { false } };
+    return scheduler->RunConcurrently(ParallelForRunner, &context, runnerCount);
+}
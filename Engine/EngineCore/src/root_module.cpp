@@ -51,7 +51,8 @@ void RaiseTransformUpdateEvent(const ServiceTable* services, const void* moduleS
         *entity
     };
 
-    writer->WriteInputEvent(&state->TransformUpdateEventOwner, event, path);
+    // transform updates are packed, the author path isn't kept
+    writer->WriteInputEvent(&state->TransformUpdateEventOwner, event);
 }
 DECLARE_SE_EVENT_4(TransformUpdateEvent, int, glm::vec3, glm::vec3, glm::vec3, RaiseTransformUpdateEvent);
 
@@ -81,7 +82,7 @@ DECLARE_SE_API_0(GetDeltaTime, float, GetTickDeltaTimeDelegate);
 static void* InitializeRootModule(ServiceTable* services)
 {
     auto newState = new RootModuleState();
-    newState->TransformUpdateEventOwner = services->EventManager->RegisterInputEvent<TransformUpdateEventData>();
+    newState->TransformUpdateEventOwner = services->EventManager->RegisterPackedEvent<TransformUpdateEventData>();
     return newState;
 }
 
@@ -94,29 +95,73 @@ static Runtime::CallbackResult EventCallback(const Runtime::ServiceTable* servic
 {
     auto state = static_cast<RootModuleState*>(moduleState);
 
-    while (eventStream.MoveNext())
+    auto transformUpdates = eventStream.Filter(&state->TransformUpdateEventOwner);
+    while (transformUpdates.MoveNext())
     {
-        if (eventStream.GetCurrentHeader().Owner != &state->TransformUpdateEventOwner)
-            continue;
-
-        auto data = (const TransformUpdateEventData*)eventStream.GetCurrentData();
-        auto foundTransform = state->SpatialComponents.find(data->EntityId);
-        if (foundTransform == state->SpatialComponents.end())
-            continue;
-
-        // apply change
-        foundTransform->second.Translation += data->NewTransform.Translation;
-        foundTransform->second.Scale *= data->NewTransform.Scale;
-        foundTransform->second.Rotation *= data->NewTransform.Rotation;
+        const TransformUpdateEventData* batch = transformUpdates.GetBatch();
+        for (size_t i = 0; i < transformUpdates.GetCount(); i++)
+        {
+            const TransformUpdateEventData& data = batch[i];
+            auto foundTransform = state->SpatialComponents.find(data.EntityId);
+            if (foundTransform == state->SpatialComponents.end())
+                continue;
+
+            // the first time this step moves the entity, keep where it was for interpolation
+            state->PreviousSpatialComponents.try_emplace(data.EntityId, foundTransform->second);
+
+            // apply change
+            foundTransform->second.Translation += data.NewTransform.Translation;
+            foundTransform->second.Scale *= data.NewTransform.Scale;
+            foundTransform->second.Rotation *= data.NewTransform.Rotation;
+        }
     }
 
     return CallbackSuccess();
 }
 
+void RootModuleState::PrepareRenderState(float interpolationAlpha, bool takeSnapshot)
+{
+    m_RenderAlpha = interpolationAlpha;
+    m_UseSnapshot = takeSnapshot;
+    if (!takeSnapshot)
+        return;
+
+    // assignment reuses the snapshot's storage, so this settles down to copying values after the first frames
+    SnapshotSpatialComponents = SpatialComponents;
+    SnapshotPreviousSpatialComponents = PreviousSpatialComponents;
+    SnapshotCameraComponents = CameraComponents;
+}
+
+bool RootModuleState::GetRenderSpatial(int entity, SpatialRelation* outRelation) const
+{
+    const auto& spatialComponents = m_UseSnapshot ? SnapshotSpatialComponents : SpatialComponents;
+    const auto& previousSpatialComponents = m_UseSnapshot ? SnapshotPreviousSpatialComponents : PreviousSpatialComponents;
+
+    auto current = spatialComponents.find(entity);
+    if (current == spatialComponents.end())
+        return false;
+
+    // entities the last step didn't move (or spawned) have nothing to blend from
+    auto previous = previousSpatialComponents.find(entity);
+    if (previous == previousSpatialComponents.end() || m_RenderAlpha >= 1)
+    {
+        *outRelation = current->second;
+        return true;
+    }
+
+    outRelation->Translation = glm::mix(previous->second.Translation, current->second.Translation, m_RenderAlpha);
+    outRelation->Scale = glm::mix(previous->second.Scale, current->second.Scale, m_RenderAlpha);
+    outRelation->Rotation = glm::slerp(previous->second.Rotation, current->second.Rotation, m_RenderAlpha);
+    return true;
+}
+
 static Runtime::CallbackResult PreupdateCallback(Runtime::ServiceTable* services, void* moduleState)
 {
     auto state = static_cast<RootModuleState*>(moduleState);
 
+    // only what this step moves is remembered, see the event callback
+    state->PreviousSpatialComponents.clear();
+
     state->TickEvent = {
         services->WorldState->GetTotalTime(),
         services->WorldState->GetDeltaTime()
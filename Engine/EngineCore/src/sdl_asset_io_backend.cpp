@@ -0,0 +1,77 @@
+#include "EngineCore/AssetManagement/sdl_asset_io_backend.h"
+#include "EngineCore/AssetManagement/io_uring_asset_io_backend.h"
+#include "SDL3/SDL_error.h"
+
+using namespace Engine::Core::AssetManagement;
+
+SdlAssetIoBackend::SdlAssetIoBackend()
+{
+    m_Queue = SDL_CreateAsyncIOQueue();
+}
+
+SdlAssetIoBackend::~SdlAssetIoBackend()
+{
+    // waits for the reads still running
+    SDL_DestroyAsyncIOQueue(m_Queue);
+}
+
+bool SdlAssetIoBackend::QueueRead(const char* path, void* destination, size_t offset, size_t size, void* userData)
+{
+    SDL_AsyncIO* ioObject = SDL_AsyncIOFromFile(path, "r");
+    if (ioObject == nullptr)
+        return false;
+
+    if (!SDL_ReadAsyncIO(ioObject, destination, offset, size, m_Queue, userData))
+    {
+        SDL_CloseAsyncIO(ioObject, false, m_Queue, nullptr);
+        return false;
+    }
+
+    return true;
+}
+
+bool SdlAssetIoBackend::GetCompletion(AssetIoCompletion* outCompletion)
+{
+    SDL_AsyncIOOutcome outcome;
+    while (SDL_GetAsyncIOResult(m_Queue, &outcome))
+    {
+        // closes are queued with null userdata, they're not worth tracking
+        if (outcome.userdata == nullptr)
+            continue;
+
+        SDL_CloseAsyncIO(outcome.asyncio, false, m_Queue, nullptr);
+
+        outCompletion->UserData = outcome.userdata;
+        outCompletion->ErrorDetail = "";
+        switch (outcome.result)
+        {
+        case SDL_ASYNCIO_COMPLETE:
+            outCompletion->Status = AssetIoStatus::Complete;
+            break;
+        case SDL_ASYNCIO_FAILURE:
+            outCompletion->Status = AssetIoStatus::Failure;
+            outCompletion->ErrorDetail = SDL_GetError();
+            break;
+        case SDL_ASYNCIO_CANCELED:
+            outCompletion->Status = AssetIoStatus::Canceled;
+            break;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+std::unique_ptr<IAssetIoBackend> Engine::Core::AssetManagement::CreateAssetIoBackend(const Configuration::ConfigurationProvider* configs)
+{
+#ifdef __linux__
+    if (configs->UseIoUring)
+    {
+        auto ioUring = std::make_unique<IoUringAssetIoBackend>();
+        if (ioUring->Initialize(configs->IoUringQueueDepth))
+            return ioUring;
+    }
+#endif
+
+    return std::make_unique<SdlAssetIoBackend>();
+}
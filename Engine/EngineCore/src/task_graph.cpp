@@ -0,0 +1,138 @@
+#include "EngineCore/Runtime/task_graph.h"
+#include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/task_manager.h"
+
+#include <string>
+
+using namespace Engine::Core::Runtime;
+
+TaskGraph::TaskGraph() : m_Scheduler(nullptr), m_Failed(false)
+{
+}
+
+size_t TaskGraph::AddJob(GenericTaskDelegate routine, void* state)
+{
+    m_Nodes.emplace_back(this, routine, state);
+    return m_Nodes.size() - 1;
+}
+
+void TaskGraph::AddDependency(size_t predecessor, size_t successor)
+{
+    m_Nodes[predecessor].Successors.push_back(successor);
+    m_Nodes[successor].PredecessorCount++;
+}
+
+void TaskGraph::SetContinuation(size_t job, GenericTaskDelegate continuation, void* state)
+{
+    m_Nodes[job].Continuation = continuation;
+    m_Nodes[job].ContinuationState = state;
+}
+
+CallbackResult TaskGraph::RunNode(void* state)
+{
+    auto node = (Node*)state;
+    TaskGraph* graph = node->Owner;
+
+    // a failed job stops its part of the graph; everything already running still finishes
+    if (graph->m_Failed.load(std::memory_order_relaxed))
+        return CallbackSuccess();
+
+    CallbackResult result = node->Routine(node->State);
+    if (!result.has_value() && node->Continuation != nullptr)
+        result = node->Continuation(node->ContinuationState);
+
+    if (result.has_value())
+    {
+        graph->m_Failed.store(true, std::memory_order_relaxed);
+        return result;
+    }
+
+    for (size_t successor : node->Successors)
+    {
+        Node& next = graph->m_Nodes[successor];
+        if (next.RemainingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            graph->m_Scheduler->ScheduleTask(RunNode, &next);
+    }
+
+    return CallbackSuccess();
+}
+
+CallbackResult TaskGraph::Prepare()
+{
+    // reset the counters and make sure every job is reachable, a cycle would otherwise never be scheduled
+    std::vector<size_t> remaining;
+    std::vector<size_t> ready;
+    remaining.reserve(m_Nodes.size());
+
+    for (size_t i = 0; i < m_Nodes.size(); i++)
+    {
+        m_Nodes[i].RemainingPredecessors.store(m_Nodes[i].PredecessorCount, std::memory_order_relaxed);
+        remaining.push_back(m_Nodes[i].PredecessorCount);
+        if (m_Nodes[i].PredecessorCount == 0)
+            ready.push_back(i);
+    }
+
+    size_t visited = 0;
+    while (!ready.empty())
+    {
+        size_t current = ready.back();
+        ready.pop_back();
+        visited++;
+
+        for (size_t successor : m_Nodes[current].Successors)
+        {
+            if (--remaining[successor] == 0)
+                ready.push_back(successor);
+        }
+    }
+
+    if (visited != m_Nodes.size())
+    {
+        std::string error("Task graph contains a cycle, ");
+        error.append(std::to_string(m_Nodes.size() - visited));
+        error.append(" job(s) can never start.");
+        return Crash(__FILE__, __LINE__, error);
+    }
+
+    m_Failed.store(false, std::memory_order_relaxed);
+    return CallbackSuccess();
+}
+
+CallbackResult TaskGraph::Dispatch(ITaskScheduler* scheduler)
+{
+    CallbackResult prepareResult = Prepare();
+    if (prepareResult.has_value())
+        return prepareResult;
+
+    m_Scheduler = scheduler;
+    for (Node& node : m_Nodes)
+    {
+        if (node.PredecessorCount == 0)
+            scheduler->ScheduleTask(RunNode, &node);
+    }
+
+    return CallbackSuccess();
+}
+
+CallbackResult TaskGraph::Run(TaskManager* taskManager)
+{
+    CallbackResult prepareResult = Prepare();
+    if (prepareResult.has_value())
+        return prepareResult;
+
+    // successors are scheduled from inside the jobs and inherit this counter
+    TaskCounter counter;
+    m_Scheduler = taskManager;
+    for (Node& node : m_Nodes)
+    {
+        if (node.PredecessorCount != 0)
+            continue;
+
+        Task task;
+        task.Type = TaskType::GenericTask;
+        task.Payload.GenericTask = { RunNode, &node };
+        taskManager->ScheduleWork(task, &counter);
+    }
+
+    return taskManager->Join(&counter);
+}
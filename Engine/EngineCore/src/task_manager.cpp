@@ -7,31 +7,39 @@
 #include "EngineCore/Runtime/task_scheduler.h"
 #include "SDL3/SDL_thread.h"
 
+#include <thread>
+
 using namespace Engine::Core::Runtime;
 
+// the task manager owning the current thread (null on non-worker threads) and the counter of the task being executed
+static thread_local const TaskManager* t_OwningManager = nullptr;
+static thread_local size_t t_QueueIndex = 0;
+static thread_local TaskCounter* t_CurrentCounter = nullptr;
+
 TaskManager::TaskManager(Engine::Core::Runtime::ServiceTable* services, Logging::LoggerService* loggerService, size_t workerCount)
-    : m_ServiceTable(services), 
-    m_Logger(services->LoggerService->CreateLogger("TaskManager")), 
-    m_WorkerLogger(services->LoggerService->CreateLogger("WorkerLogger"))
+    : m_Queues(std::make_unique<WorkQueue[]>(workerCount + 1)),
+    m_QueueCount(workerCount + 1),
+    m_ShuttingDown(false),
+    m_ServiceTable(services),
+    m_Logger(loggerService->CreateLogger("TaskManager")),
+    m_WorkerLogger(loggerService->CreateLogger("WorkerLogger"))
 {
+    // contexts are handed out by pointer, so they must not move after this point
+    m_WorkerContexts.reserve(workerCount);
     m_WorkerThreads.reserve(workerCount);
     for (size_t i = 0; i < workerCount; i++)
     {
-        SDL_Thread* newThread = SDL_CreateThread(ThreadRoutine, "Worker Thread", this);
+        m_WorkerContexts.push_back({ this, i });
+        SDL_Thread* newThread = SDL_CreateThread(ThreadRoutine, "Worker Thread", &m_WorkerContexts.back());
         m_WorkerThreads.push_back(newThread);
     }
 }
 
 TaskManager::~TaskManager()
 {
-    // shut down all threads 
-    for (size_t i = 0; i < m_WorkerThreads.size(); i++)
-    {
-        m_TaskQueue.enqueue({ TaskType::ShutDown });
-    }
-
-    // setting a termiantion signal to skip any existing tasks
-    m_TerminationSignal.signal(m_WorkerThreads.size());
+    // remaining tasks are skipped, same as before
+    m_ShuttingDown.store(true);
+    m_WorkAvailable.signal(m_WorkerThreads.size());
 
     for (SDL_Thread* thread : m_WorkerThreads)
     {
@@ -41,93 +49,209 @@ TaskManager::~TaskManager()
     m_Logger.Information("Worker threads exited.");
 }
 
+size_t TaskManager::GetLocalQueueIndex() const
+{
+    if (t_OwningManager == this)
+        return t_QueueIndex;
+
+    return m_QueueCount - 1;
+}
+
+bool TaskManager::TryPopLocal(size_t queueIndex, Task& outTask)
+{
+    WorkQueue& queue = m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.Lock);
+
+    if (queue.Tasks.empty())
+        return false;
+
+    outTask = queue.Tasks.back();
+    queue.Tasks.pop_back();
+    return true;
+}
+
+bool TaskManager::TrySteal(size_t thiefIndex, Task& outTask)
+{
+    for (size_t offset = 1; offset < m_QueueCount; offset++)
+    {
+        WorkQueue& queue = m_Queues[(thiefIndex + offset) % m_QueueCount];
+
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        if (queue.Tasks.empty())
+            continue;
+
+        outTask = queue.Tasks.front();
+        queue.Tasks.pop_front();
+        return true;
+    }
+
+    return false;
+}
+
+bool TaskManager::TryRunOne()
+{
+    size_t queueIndex = GetLocalQueueIndex();
+
+    Task task;
+    if (!TryPopLocal(queueIndex, task) && !TrySteal(queueIndex, task))
+        return false;
+
+    Execute(task);
+    return true;
+}
+
 static CallbackResult ProcessInputEvent(const ServiceTable* services, ITaskScheduler* scheduler, void* moduleState, Engine::Core::Pipeline::EventCallbackDelegate callback, EventWriter* eventWriters, size_t eventWriterCount)
 {
-    for (size_t i = 0; i < eventWriterCount; i++)
+    // one pass over all writers, in the order they were handed in
+    return callback(services, scheduler, moduleState, EventWriter::OpenReadStream(eventWriters, eventWriterCount));
+}
+
+void TaskManager::Execute(const Task& task)
+{
+    // tasks can be nested when a join helps out, restore the outer counter afterwards
+    TaskCounter* outerCounter = t_CurrentCounter;
+    t_CurrentCounter = task.Counter;
+
+    CallbackResult result;
+    switch (task.Type)
+    {
+    case TaskType::ProcessInputEvents:
+        result = ProcessInputEvent(
+            m_ServiceTable,
+            this,
+            task.Payload.ProcessInputEventsTask.Routine.InstanceState,
+            task.Payload.ProcessInputEventsTask.Routine.Callback,
+            task.Payload.ProcessInputEventsTask.EventWriters,
+            task.Payload.ProcessInputEventsTask.EventWriterCount
+        );
+        break;
+    case TaskType::GenericTask:
+        result = task.Payload.GenericTask.Routine(task.Payload.GenericTask.State);
+        break;
+    }
+
+    t_CurrentCounter = outerCounter;
+
+    if (task.Counter == nullptr)
     {
-        CallbackResult result = callback(services, scheduler, moduleState, eventWriters[i].OpenReadStream());
         if (result.has_value())
-            return result;
+            m_WorkerLogger.Error("Detached task failed at {}:{}, error: {}", result->File, result->Line, result->ErrorDetail);
+        return;
     }
 
-    return CallbackSuccess();
+    if (result.has_value() && !task.Counter->Failed.exchange(true))
+        task.Counter->Error = result;
+
+    // release the error and all side effects of the task to whoever joins on the counter
+    task.Counter->Pending.fetch_sub(1, std::memory_order_acq_rel);
 }
 
-class TaskLocalScheduler : public ITaskScheduler
+void TaskManager::ScheduleWork(Task task, TaskCounter* counter)
 {
-private:
-    Engine::Core::Logging::Logger* m_Logger;
-    TaskManager* m_TaskManager;
-    size_t m_ScheduleCount;
-
-public:
-    TaskLocalScheduler(Engine::Core::Logging::Logger* logger, TaskManager* taskManager) 
-        : m_Logger(logger), m_TaskManager(taskManager), m_ScheduleCount(0) 
+    task.Counter = counter;
+    if (counter != nullptr)
+        counter->Pending.fetch_add(1, std::memory_order_relaxed);
+
+    WorkQueue& queue = m_Queues[GetLocalQueueIndex()];
     {
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        queue.Tasks.push_back(task);
     }
 
-    void ScheduleTask(GenericTaskDelegate routine, void *state) override 
+    m_WorkAvailable.signal();
+}
+
+CallbackResult TaskManager::Join(TaskCounter* counter)
+{
+    while (counter->Pending.load(std::memory_order_acquire) > 0)
     {
-        Task task;
-        task.Type = Engine::Core::Runtime::TaskType::GenericTask;
-        task.Payload.GenericTask = { routine, state };
-        m_TaskManager->ScheduleWork(task);
-        m_ScheduleCount++;
+        if (!TryRunOne())
+            std::this_thread::yield();
     }
 
-    size_t GetSchedulCount() const
+    if (counter->Failed.load(std::memory_order_acquire))
+        return counter->Error;
+
+    return CallbackSuccess();
+}
+
+void TaskManager::ScheduleTask(GenericTaskDelegate routine, void* state)
+{
+    Task task;
+    task.Type = TaskType::GenericTask;
+    task.Payload.GenericTask = { routine, state };
+    ScheduleWork(task, t_CurrentCounter);
+}
+
+struct ConcurrentRun
+{
+    ConcurrentTaskDelegate Routine;
+    void* State;
+    std::atomic<size_t> NextRunner;
+};
+
+static CallbackResult RunConcurrentRunner(void* state)
+{
+    auto run = (ConcurrentRun*)state;
+    return run->Routine(run->State, run->NextRunner.fetch_add(1, std::memory_order_relaxed));
+}
+
+CallbackResult TaskManager::RunConcurrently(ConcurrentTaskDelegate routine, void* state, size_t runnerCount)
+{
+    if (runnerCount == 0)
+        return CallbackSuccess();
+
+    // runners claim their index when they start, so they all share one piece of state on the caller's stack
+    ConcurrentRun run { routine, state, 0 };
+    TaskCounter counter;
+
+    for (size_t i = 1; i < runnerCount; i++)
     {
-        return m_ScheduleCount;
+        Task task;
+        task.Type = TaskType::GenericTask;
+        task.Payload.GenericTask = { RunConcurrentRunner, &run };
+        ScheduleWork(task, &counter);
     }
-};
+
+    // the calling thread is one of the runners
+    counter.Pending.fetch_add(1, std::memory_order_relaxed);
+    Task inlineTask;
+    inlineTask.Type = TaskType::GenericTask;
+    inlineTask.Counter = &counter;
+    inlineTask.Payload.GenericTask = { RunConcurrentRunner, &run };
+    Execute(inlineTask);
+
+    return Join(&counter);
+}
 
 int TaskManager::ThreadRoutine(void* state)
 {
-    auto taskManager = (TaskManager*)state;
+    auto context = (WorkerContext*)state;
+    TaskManager* taskManager = context->Owner;
+
+    t_OwningManager = taskManager;
+    t_QueueIndex = context->QueueIndex;
 
     Logging::Logger logger = taskManager->m_WorkerLogger;
 
     logger.Information("Task worker initiated.");
 
-    bool keepRunning = true;
-    while (keepRunning)
+    while (true)
     {
-        if (taskManager->m_TerminationSignal.tryWait())
-            break;
+        taskManager->m_WorkAvailable.wait();
 
-        Task task;
-        taskManager->m_TaskQueue.wait_dequeue(task);
+        if (taskManager->m_ShuttingDown.load())
+            break;
 
-        switch (task.Type)
+        // one signal is posted per task, but drain everything reachable before sleeping again; surplus signals only
+        // cause a spurious wake up
+        while (taskManager->TryRunOne())
         {
-        case TaskType::ShutDown:
-            keepRunning = false;
-            break;
-        case TaskType::ProcessInputEvents:
-            {
-                TaskLocalScheduler localScheduler(&logger, taskManager);
-
-                CallbackResult result = ProcessInputEvent(
-                    taskManager->m_ServiceTable,
-                    &localScheduler,
-                    task.Payload.ProcessInputEventsTask.Routine.InstanceState, 
-                    task.Payload.ProcessInputEventsTask.Routine.Callback,
-                    task.Payload.ProcessInputEventsTask.EventWriters,
-                    task.Payload.ProcessInputEventsTask.EventWriterCount
-                );
-
-                taskManager->m_ResultQueue.enqueue({ result, localScheduler.GetSchedulCount() });
-            }
-            break;
-        case TaskType::GenericTask:
-            {
-                CallbackResult result = task.Payload.GenericTask.Routine(task.Payload.GenericTask.State);
-                taskManager->m_ResultQueue.enqueue({ result, 0 });
-            }
-            break;
+            if (taskManager->m_ShuttingDown.load())
+                break;
         }
     }
 
     logger.Information("Task worker teminated.");
     return 0;
-}
\ No newline at end of file
+}
@@ -4,71 +4,272 @@
 
 using namespace Engine::Core::Runtime;
 
-TransientAllocator::TransientAllocator(Engine::Core::Logging::LoggerService* loggerService)
-    :m_Logger(loggerService->CreateLogger("TransientAllocator"))
+thread_local ThreadCache<TransientAllocator::ThreadArena> TransientAllocator::s_CachedArena;
+
+TransientAllocator::TransientAllocator(Engine::Core::Logging::LoggerService* loggerService, MemoryTracker* memoryTracker)
+    :m_Logger(loggerService->CreateLogger("TransientAllocator")),
+    m_MemoryTracker(memoryTracker),
+    m_GroupChunkCount(0)
 {
-    m_Buffers.resize(16);
+    for (auto& chunk : m_GroupChunks)
+    {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
 }
 
-TransientBufferId Engine::Core::Runtime::TransientAllocator::CreateBufferGroup(size_t totalSize, int childCount)
+TransientAllocator::~TransientAllocator()
 {
-    int targetIndex;
-    for (targetIndex = 0; targetIndex < m_Buffers.size() && m_Buffers[targetIndex].Buffer != nullptr; targetIndex++) {}
+    for (int i = 0; i < m_GroupChunkCount; i++)
+    {
+        delete[] m_GroupChunks[i].load(std::memory_order_relaxed);
+    }
 
-    if (targetIndex == m_Buffers.size())
+    for (auto& page : m_Pages)
     {
-        m_Buffers.push_back({nullptr, 0});
+        free(page->Memory);
     }
+}
+
+TransientAllocator::ThreadArena* TransientAllocator::GetThreadArena()
+{
+    if (ThreadArena* cached = s_CachedArena.Find(m_CacheKey))
+        return cached;
 
-    m_Buffers[targetIndex].Buffer = malloc(totalSize);
-    m_Buffers[targetIndex].ChildCount = childCount;
+    std::thread::id thread = std::this_thread::get_id();
+    ThreadArena* arena = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& existing : m_Arenas)
+        {
+            if (existing->Thread == thread)
+                arena = existing.get();
+        }
 
-    m_Logger.Information("Allocating buffer group #{} of {} bytes, with {} children.", targetIndex, totalSize, childCount);
+        // arenas live as long as the allocator, worker threads do as well
+        if (arena == nullptr)
+        {
+            m_Arenas.push_back(std::make_unique<ThreadArena>());
+            arena = m_Arenas.back().get();
+            arena->Thread = thread;
+        }
+    }
 
-    return { targetIndex, 0 };
+    s_CachedArena.Store(m_CacheKey, arena);
+    return arena;
 }
 
-void Engine::Core::Runtime::TransientAllocator::Return(TransientBufferId id)
+TransientAllocator::Page* TransientAllocator::AcquirePage(size_t size)
 {
-    int parent = id.Parent;
+    std::lock_guard<std::mutex> lock(m_Mutex);
 
-    if (parent < 0 || parent >= m_Buffers.size())
+    // a spare page is only ever a regular one, it's as good as new
+    if (size == PageSize && !m_SparePages.empty())
     {
-        m_Logger.Warning("Trying to return transient buffer out of allocated range! Available: 0-{}, got: {}.", m_Buffers.size() - 1, parent);
-        return;
+        Page* spare = m_SparePages.back();
+        m_SparePages.pop_back();
+        return spare;
     }
 
-    if (m_Buffers[parent].Buffer == nullptr)
+    unsigned char* memory = static_cast<unsigned char*>(malloc(size));
+    if (memory == nullptr)
+        return nullptr;
+
+    m_Pages.push_back(std::make_unique<Page>());
+    Page* page = m_Pages.back().get();
+    page->Memory = memory;
+    page->Size = size;
+    m_Logger.Verbose("Transient page of {} bytes allocated, {} page(s) in use.", size, m_Pages.size());
+    return page;
+}
+
+void TransientAllocator::ReleasePage(Page* page)
+{
+    if (page->LiveGroups.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    page->Used = 0;
+    if (page->Size == PageSize && m_SparePages.size() < SparePageCount)
     {
-        m_Logger.Warning("Trying to return transient buffer already deallocated! Index: {}.", parent);
+        m_SparePages.push_back(page);
         return;
     }
 
-    m_Buffers[parent].ChildCount --;
-    if (m_Buffers[parent].ChildCount <= 0)
+    for (size_t i = 0; i < m_Pages.size(); i++)
     {
-        free(m_Buffers[parent].Buffer);
-        m_Buffers[parent].Buffer = nullptr;
-        m_Logger.Information("Transient buffer group #{} deallocated.", parent);
+        if (m_Pages[i].get() == page)
+        {
+            free(page->Memory);
+            m_Pages[i] = std::move(m_Pages.back());
+            m_Pages.pop_back();
+            break;
+        }
     }
+    m_Logger.Verbose("Transient page released, {} page(s) in use.", m_Pages.size());
 }
 
-void *Engine::Core::Runtime::TransientAllocator::GetBuffer(TransientBufferId id) 
+TransientAllocator::BufferGroup* TransientAllocator::ResolveGroup(int slot) const
+{
+    if (slot < 0 || slot / GroupChunkSize >= MaxGroupChunks)
+        return nullptr;
+
+    BufferGroup* chunk = m_GroupChunks[slot / GroupChunkSize].load(std::memory_order_acquire);
+    return chunk != nullptr ? chunk + slot % GroupChunkSize : nullptr;
+}
+
+int TransientAllocator::ClaimGroupSlot(ThreadArena* arena)
+{
+    if (arena->FreeGroups.empty())
+    {
+        int returned = arena->ReturnedGroups.exchange(-1, std::memory_order_acquire);
+        while (returned >= 0)
+        {
+            arena->FreeGroups.push_back(returned);
+            returned = ResolveGroup(returned)->NextFree;
+        }
+    }
+
+    if (arena->FreeGroups.empty())
+    {
+        BufferGroup* chunk = nullptr;
+        int chunkIndex;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_GroupChunkCount == MaxGroupChunks)
+                return -1;
+
+            chunk = new BufferGroup[GroupChunkSize];
+            chunkIndex = m_GroupChunkCount++;
+        }
+
+        for (int i = 0; i < GroupChunkSize; i++)
+        {
+            chunk[i].Arena = arena;
+        }
+        m_GroupChunks[chunkIndex].store(chunk, std::memory_order_release);
+
+        // lowest slots first
+        for (int i = GroupChunkSize - 1; i >= 0; i--)
+        {
+            arena->FreeGroups.push_back(chunkIndex * GroupChunkSize + i);
+        }
+    }
+
+    int slot = arena->FreeGroups.back();
+    arena->FreeGroups.pop_back();
+    return slot;
+}
+
+TransientAllocator::BufferGroup* TransientAllocator::FindGroup(TransientBufferId id, const char* action)
 {
     int parent = id.Parent;
 
-    if (parent < 0 || parent >= m_Buffers.size())
+    BufferGroup* group = ResolveGroup(parent);
+    if (group == nullptr)
     {
-        m_Logger.Warning("Trying to access transient buffer out of allocated range! Available: 0-{}, got: {}.", m_Buffers.size() - 1, parent);
+        m_Logger.Warning("Trying to {} transient buffer out of allocated range! Got: {}.", action, parent);
         return nullptr;
     }
 
-    if (m_Buffers[parent].Buffer == nullptr)
+    if (group->Buffer == nullptr || group->Generation.load(std::memory_order_acquire) != id.Generation)
     {
-        m_Logger.Warning("Trying to access transient buffer already deallocated! Index: {}.", parent);
+        m_Logger.Warning("Trying to {} transient buffer already deallocated! Index: {}.", action, parent);
         return nullptr;
     }
 
-    unsigned char* buffer = static_cast<unsigned char*>(m_Buffers[parent].Buffer);
-    return buffer + id.Child;
+    return group;
+}
+
+TransientBufferId Engine::Core::Runtime::TransientAllocator::CreateBufferGroup(size_t totalSize, int childCount, MemoryOwner owner)
+{
+    size_t size = totalSize > 0 ? (totalSize + GroupAlignment - 1) & ~(GroupAlignment - 1) : GroupAlignment;
+    ThreadArena* arena = GetThreadArena();
+
+    int targetIndex = ClaimGroupSlot(arena);
+    if (targetIndex < 0)
+    {
+        m_Logger.Error("Out of transient buffer group slots, {} bytes can't be allocated.", totalSize);
+        return { -1, 0, 0 };
+    }
+
+    Page* page;
+    if (size > PageSize)
+    {
+        page = AcquirePage(size);
+    }
+    else
+    {
+        // nothing but the arena's own hold is left, the page starts over
+        Page* current = arena->CurrentPage;
+        if (current != nullptr && current->LiveGroups.load(std::memory_order_acquire) == 1)
+            current->Used = 0;
+
+        if (current == nullptr || current->Used + size > PageSize)
+        {
+            // the full page is reclaimed when its last group comes back
+            arena->CurrentPage = AcquirePage(PageSize);
+            if (arena->CurrentPage != nullptr)
+                arena->CurrentPage->LiveGroups.fetch_add(1, std::memory_order_relaxed);
+            if (current != nullptr)
+                ReleasePage(current);
+        }
+        page = arena->CurrentPage;
+    }
+
+    if (page == nullptr)
+    {
+        m_Logger.Error("Failed to allocate a transient page for a buffer group of {} bytes.", totalSize);
+        arena->FreeGroups.push_back(targetIndex);
+        return { -1, 0, 0 };
+    }
+
+    BufferGroup* group = ResolveGroup(targetIndex);
+    group->Buffer = page->Memory + page->Used;
+    group->OwnerPage = page;
+    group->Size = size;
+    group->Owner = owner;
+    group->ChildCount.store(childCount, std::memory_order_relaxed);
+    page->Used += size;
+    page->LiveGroups.fetch_add(1, std::memory_order_relaxed);
+    m_MemoryTracker->TrackAllocation(MemorySubsystem::TransientBuffers, owner, size);
+
+    m_Logger.Verbose("Allocating buffer group #{} of {} bytes, with {} children.", targetIndex, totalSize, childCount);
+
+    return { targetIndex, 0, group->Generation.load(std::memory_order_relaxed) };
+}
+
+void Engine::Core::Runtime::TransientAllocator::Return(TransientBufferId id)
+{
+    BufferGroup* group = FindGroup(id, "return");
+    if (group == nullptr)
+        return;
+
+    if (group->ChildCount.fetch_sub(1, std::memory_order_acq_rel) > 1)
+        return;
+
+    Page* page = group->OwnerPage;
+    ThreadArena* arena = group->Arena;
+    group->Buffer = nullptr;
+    group->OwnerPage = nullptr;
+    group->Generation.fetch_add(1, std::memory_order_release);
+    m_MemoryTracker->TrackFree(MemorySubsystem::TransientBuffers, group->Owner, group->Size);
+    m_Logger.Verbose("Transient buffer group #{} deallocated.", id.Parent);
+
+    // the slot belongs to the arena from here on, it may be reused right away
+    int head = arena->ReturnedGroups.load(std::memory_order_relaxed);
+    do
+    {
+        group->NextFree = head;
+    } while (!arena->ReturnedGroups.compare_exchange_weak(head, id.Parent, std::memory_order_release, std::memory_order_relaxed));
+
+    ReleasePage(page);
+}
+
+void *Engine::Core::Runtime::TransientAllocator::GetBuffer(TransientBufferId id)
+{
+    BufferGroup* group = FindGroup(id, "access");
+    if (group == nullptr)
+        return nullptr;
+
+    return group->Buffer + id.Child;
 }
@@ -1,4 +1,5 @@
 #include "EngineCore/Runtime/world_state.h"
+#include "EngineCore/Configuration/configuration_provider.h"
 #include "EngineCore/Ecs/entity.h"
 #include "EngineUtils/Memory/memstream_lite.h"
 #include "SDL3/SDL_timer.h"
@@ -34,6 +35,44 @@ bool WorldState::LoadEntities(Engine::Utils::Memory::MemStreamLite& stream)
 
 void WorldState::Tick()
 {
-    m_DeltaTime = (SDL_GetTicksNS() - m_TotalTime * 1000000) / 1000000;
-    m_TotalTime = (float)SDL_GetTicksNS() / 1000000;
-}
\ No newline at end of file
+    Uint64 ticks = SDL_GetTicksNS();
+    float elapsed = m_LastTicks == 0 ? 0 : (float)(ticks - m_LastTicks) / 1000000;
+    m_LastTicks = ticks;
+
+    if (!m_Configs->UseFixedTimeStep)
+    {
+        m_DeltaTime = elapsed;
+        m_TotalTime += elapsed;
+        m_VariableStepPending = true;
+        return;
+    }
+
+    // cap the catch up so one long frame doesn't make the next ones even longer
+    float maxAccumulated = m_Configs->FixedTimeStep * m_Configs->MaxSimulationSteps;
+    m_Accumulator += elapsed;
+    if (m_Accumulator > maxAccumulated)
+        m_Accumulator = maxAccumulated;
+}
+
+bool WorldState::NextStep()
+{
+    if (!m_Configs->UseFixedTimeStep)
+    {
+        // variable steps run exactly once per tick and always render the latest state
+        bool pending = m_VariableStepPending;
+        m_VariableStepPending = false;
+        m_InterpolationAlpha = 1;
+        return pending;
+    }
+
+    if (m_Accumulator < m_Configs->FixedTimeStep)
+    {
+        m_InterpolationAlpha = m_Accumulator / m_Configs->FixedTimeStep;
+        return false;
+    }
+
+    m_Accumulator -= m_Configs->FixedTimeStep;
+    m_DeltaTime = m_Configs->FixedTimeStep;
+    m_TotalTime += m_Configs->FixedTimeStep;
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Engine::Utils::Compression {
+
+// LZ4 style block format: a sequence is a token (literal length, match length - 4), the literals, then a two byte
+// backwards offset into the output; the last sequence only has literals. Blocks are independent of each other so any
+// number of them can be decoded at the same time.
+
+// worst case size of a compressed block, data that doesn't compress grows by a little bit
+constexpr size_t BlockCompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+// returns the compressed size, or 0 if the result doesn't fit into capacity
+size_t CompressBlock(const void* source, size_t sourceSize, void* destination, size_t capacity);
+
+// true only if the block is well formed and decodes to exactly destinationSize bytes; never reads or writes outside
+// the given ranges, so it's safe on corrupted input
+bool DecompressBlock(const void* source, size_t sourceSize, void* destination, size_t destinationSize);
+
+}
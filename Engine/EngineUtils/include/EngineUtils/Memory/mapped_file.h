@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Engine::Utils::Memory {
+
+// read-only view of a whole file through the OS page cache; pages are mapped copy-on-write, so callers may hand out
+// mutable pointers into the view without ever touching the file on disk
+class MappedFile
+{
+private:
+    void* m_Data = nullptr;
+    size_t m_Size = 0;
+
+#ifdef _WIN32
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // maps the entire file, returns false (and stays closed) if the file is missing or empty
+    bool Open(const char* path);
+    void Close();
+
+    inline bool IsOpen() const { return m_Data != nullptr; }
+    inline void* GetData() const { return m_Data; }
+    inline size_t GetSize() const { return m_Size; }
+};
+
+}
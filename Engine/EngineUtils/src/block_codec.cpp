@@ -0,0 +1,216 @@
+#include "EngineUtils/Compression/block_codec.h"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace Engine::Utils::Compression;
+
+static constexpr size_t MinMatch = 4;
+static constexpr size_t LastLiterals = 5;
+static constexpr size_t MatchSearchLimit = 12;
+static constexpr size_t MaxDistance = 65535;
+static constexpr int HashBits = 12;
+
+static inline uint32_t Read32(const unsigned char* source)
+{
+    uint32_t value;
+    memcpy(&value, source, sizeof(value));
+    return value;
+}
+
+static inline uint32_t Hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+// the 4 bit field saturates at 15, the rest follows as a run of bytes that end with one below 255
+static inline unsigned char* WriteLength(unsigned char* output, size_t length)
+{
+    length -= 15;
+    while (length >= 255)
+    {
+        *output++ = 255;
+        length -= 255;
+    }
+    *output++ = (unsigned char)length;
+    return output;
+}
+
+static inline bool ReadLength(const unsigned char*& input, const unsigned char* inputEnd, size_t& length)
+{
+    unsigned char next;
+    do
+    {
+        if (input >= inputEnd)
+            return false;
+
+        next = *input++;
+        length += next;
+    } while (next == 255);
+
+    return true;
+}
+
+size_t Engine::Utils::Compression::CompressBlock(const void* source, size_t sourceSize, void* destination, size_t capacity)
+{
+    const unsigned char* input = static_cast<const unsigned char*>(source);
+    const unsigned char* inputEnd = input + sourceSize;
+    const unsigned char* anchor = input;
+    unsigned char* output = static_cast<unsigned char*>(destination);
+    unsigned char* outputEnd = output + capacity;
+
+    // positions relative to the start of the block, stale entries are caught by comparing the bytes
+    uint32_t table[1 << HashBits] = {};
+
+    if (sourceSize > MatchSearchLimit)
+    {
+        const unsigned char* cursor = input;
+        const unsigned char* searchEnd = inputEnd - MatchSearchLimit;
+        const unsigned char* matchEnd = inputEnd - LastLiterals;
+        size_t misses = 0;
+
+        while (cursor < searchEnd)
+        {
+            uint32_t sequence = Read32(cursor);
+            uint32_t hash = Hash(sequence);
+            const unsigned char* candidate = input + table[hash];
+            table[hash] = (uint32_t)(cursor - input);
+
+            if (candidate >= cursor || (size_t)(cursor - candidate) > MaxDistance || Read32(candidate) != sequence)
+            {
+                // skip faster through data that doesn't compress
+                cursor += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            size_t matchLength = MinMatch;
+            while (cursor + matchLength < matchEnd && cursor[matchLength] == candidate[matchLength])
+            {
+                matchLength++;
+            }
+
+            size_t literalLength = cursor - anchor;
+            if ((size_t)(outputEnd - output) < 1 + literalLength + literalLength / 255 + 1 + 2 + (matchLength - MinMatch) / 255 + 1)
+                return 0;
+
+            unsigned char* token = output++;
+            if (literalLength >= 15)
+            {
+                *token = 15 << 4;
+                output = WriteLength(output, literalLength);
+            }
+            else
+            {
+                *token = (unsigned char)(literalLength << 4);
+            }
+
+            memcpy(output, anchor, literalLength);
+            output += literalLength;
+
+            size_t offset = cursor - candidate;
+            *output++ = (unsigned char)(offset & 0xFF);
+            *output++ = (unsigned char)(offset >> 8);
+
+            size_t encodedMatch = matchLength - MinMatch;
+            if (encodedMatch >= 15)
+            {
+                *token |= 15;
+                output = WriteLength(output, encodedMatch);
+            }
+            else
+            {
+                *token |= (unsigned char)encodedMatch;
+            }
+
+            cursor += matchLength;
+            anchor = cursor;
+        }
+    }
+
+    // whatever is left goes out as literals
+    size_t literalLength = inputEnd - anchor;
+    if ((size_t)(outputEnd - output) < 1 + literalLength + literalLength / 255 + 1)
+        return 0;
+
+    unsigned char* token = output++;
+    if (literalLength >= 15)
+    {
+        *token = 15 << 4;
+        output = WriteLength(output, literalLength);
+    }
+    else
+    {
+        *token = (unsigned char)(literalLength << 4);
+    }
+
+    // an empty block may come without a buffer, memcpy isn't allowed to see a null pointer even for no bytes
+    if (literalLength > 0)
+        memcpy(output, anchor, literalLength);
+    output += literalLength;
+
+    return output - static_cast<unsigned char*>(destination);
+}
+
+bool Engine::Utils::Compression::DecompressBlock(const void* source, size_t sourceSize, void* destination, size_t destinationSize)
+{
+    const unsigned char* input = static_cast<const unsigned char*>(source);
+    const unsigned char* inputEnd = input + sourceSize;
+    unsigned char* outputBegin = static_cast<unsigned char*>(destination);
+    unsigned char* output = outputBegin;
+    unsigned char* outputEnd = output + destinationSize;
+
+    while (input < inputEnd)
+    {
+        unsigned char token = *input++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(input, inputEnd, literalLength))
+            return false;
+
+        if (literalLength > (size_t)(inputEnd - input) || literalLength > (size_t)(outputEnd - output))
+            return false;
+
+        if (literalLength > 0)
+            memcpy(output, input, literalLength);
+        input += literalLength;
+        output += literalLength;
+
+        // the last sequence ends right after its literals
+        if (input == inputEnd)
+            break;
+
+        if (inputEnd - input < 2)
+            return false;
+
+        size_t offset = input[0] | (input[1] << 8);
+        input += 2;
+        if (offset == 0 || offset > (size_t)(output - outputBegin))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength))
+            return false;
+        matchLength += MinMatch;
+
+        if (matchLength > (size_t)(outputEnd - output))
+            return false;
+
+        // overlapping matches repeat the bytes just written, they have to be copied front to back
+        const unsigned char* match = output - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(output, match, matchLength);
+            output += matchLength;
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                *output++ = *match++;
+            }
+        }
+    }
+
+    return output == outputEnd;
+}
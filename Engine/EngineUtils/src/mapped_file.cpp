@@ -0,0 +1,134 @@
+#include "EngineUtils/Memory/mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Engine::Utils::Memory;
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    Close();
+    std::swap(m_Data, other.m_Data);
+    std::swap(m_Size, other.m_Size);
+#ifdef _WIN32
+    std::swap(m_FileHandle, other.m_FileHandle);
+    std::swap(m_MappingHandle, other.m_MappingHandle);
+#endif
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* path)
+{
+    Close();
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle = file;
+    m_MappingHandle = mapping;
+    m_Data = data;
+    m_Size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data != nullptr)
+        UnmapViewOfFile(m_Data);
+    if (m_MappingHandle != nullptr)
+        CloseHandle((HANDLE)m_MappingHandle);
+    if (m_FileHandle != nullptr)
+        CloseHandle((HANDLE)m_FileHandle);
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_FileHandle = nullptr;
+    m_MappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const char* path)
+{
+    Close();
+
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // the mapping keeps its own reference to the file
+    void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    m_Data = data;
+    m_Size = (size_t)status.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data != nullptr)
+        munmap(m_Data, m_Size);
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+#endif
@@ -35,12 +35,10 @@ static Core::Runtime::CallbackResult EventUpdate(const Core::Runtime::ServiceTab
 {
     ModuleState* state = static_cast<ModuleState*>(moduleState);
 
-    while (events.MoveNext())
+    auto yells = events.Filter(&state->YellOwner);
+    while (yells.MoveNext())
     {
-        if (events.GetCurrentHeader().Owner != &state->YellOwner)
-            continue;
-
-        auto eventPtr = (YellEvent*)events.GetCurrentData();
+        const YellEvent* eventPtr = yells.GetCurrent();
         state->Logger.Information(eventPtr->Content);
     }
 
@@ -5,6 +5,7 @@
 #include "EngineCore/Pipeline/variant.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/event_writer.h"
+#include "EngineCore/Runtime/memory_tracker.h"
 #include "EngineCore/Runtime/service_table.h"
 #include "EngineCore/Scripting/api_event.h"
 #include "EngineCore/Scripting/api_query.h"
@@ -20,6 +21,9 @@ private:
 
     Core::Logging::Logger m_Logger;
 
+    // everything the lua state allocates is counted as scripting memory of this owner
+    Core::Runtime::MemoryOwner m_MemoryOwner;
+
     std::vector<InstancedApiQuery> m_ApiQueryList;
     std::vector<InstancedApiEvent> m_ApiEventList;
 
@@ -31,6 +35,8 @@ private:
     static int LuaQuery(lua_State* luaState);
     static int L1CallMultiplexer(lua_State* luaState);
     static int LuaPrint(lua_State* luaState);
+    static int LuaPanic(lua_State* luaState);
+    static void* LuaAllocate(void* userData, void* buffer, size_t oldSize, size_t newSize);
 
     class StackBalancer
     {
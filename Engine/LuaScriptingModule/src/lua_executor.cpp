@@ -3,6 +3,7 @@
 #include "EngineCore/Pipeline/variant.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/event_writer.h"
+#include "EngineCore/Runtime/memory_tracker.h"
 #include "EngineCore/Runtime/service_table.h"
 #include "EngineCore/Scripting/api_data.h"
 #include "EngineCore/Logging/logger_service.h"
@@ -12,6 +13,7 @@
 #include "EngineCore/Runtime/module_manager.h"
 #include "LuaScriptingModule/state_data.h"
 #include <md5.h>
+#include <cstdlib>
 
 using namespace Engine::Extension::LuaScriptingModule;
 
@@ -566,9 +568,54 @@ void LuaExecutor::Initialize()
     m_Logger.Information("Lua executor initialized.");
 }
 
-LuaExecutor::LuaExecutor(const Engine::Core::Runtime::ServiceTable* services) : m_Services(services), m_Logger(services->LoggerService->CreateLogger("LuaExecutor"))
+void* LuaExecutor::LuaAllocate(void* userData, void* buffer, size_t oldSize, size_t newSize)
 {
-    m_LuaState = luaL_newstate();
+    LuaExecutor* executor = static_cast<LuaExecutor*>(userData);
+    Core::Runtime::MemoryTracker* tracker = executor->m_Services->MemoryTracker;
+
+    // without a buffer the old size is the type of the object being created
+    if (buffer != nullptr)
+        tracker->TrackFree(Core::Runtime::MemorySubsystem::Scripting, executor->m_MemoryOwner, oldSize);
+
+    if (newSize == 0)
+    {
+        free(buffer);
+        return nullptr;
+    }
+
+    void* newBuffer = realloc(buffer, newSize);
+
+    // a failed reallocation leaves the old buffer to lua
+    if (newBuffer == nullptr)
+    {
+        if (buffer != nullptr)
+            tracker->TrackAllocation(Core::Runtime::MemorySubsystem::Scripting, executor->m_MemoryOwner, oldSize);
+        return nullptr;
+    }
+
+    tracker->TrackAllocation(Core::Runtime::MemorySubsystem::Scripting, executor->m_MemoryOwner, newSize);
+    return newBuffer;
+}
+
+// errors outside of a protected call end up here right before lua aborts
+int LuaExecutor::LuaPanic(lua_State* luaState)
+{
+    void* userData;
+    lua_getallocf(luaState, &userData);
+    const char* message = lua_tostring(luaState, -1);
+    static_cast<LuaExecutor*>(userData)->m_Logger.Error("Unprotected error in lua: {}", message != nullptr ? message : "error object is not a string");
+    return 0;
+}
+
+LuaExecutor::LuaExecutor(const Engine::Core::Runtime::ServiceTable* services) 
+    : m_Services(services), 
+    m_Logger(services->LoggerService->CreateLogger("LuaExecutor")),
+    m_MemoryOwner(services->MemoryTracker->RegisterOwner("LuaScriptingModule"))
+{
+    m_LuaState = lua_newstate(LuaAllocate, this);
+
+    // unlike luaL_newstate, lua_newstate doesn't install a panic handler that reports the error
+    lua_atpanic(m_LuaState, LuaPanic);
     luaL_openlibs(m_LuaState);
 }
 
@@ -15,6 +15,7 @@ int main()
         controller->LoadModules();
 
         controller->BeginFrame();
+        controller->Tick();
         controller->Preupdate();
 
         std::cout << "*** LUA RUNTIME START ***" << std::endl;
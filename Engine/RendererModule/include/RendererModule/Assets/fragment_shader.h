@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EngineCore/AssetManagement/asset_loading_context.h"
+#include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/fwd.h"
 #include "SDL3/SDL_gpu.h"
@@ -15,6 +16,9 @@ Engine::Core::Runtime::CallbackResult ContextualizeFragmentShader(
 Engine::Core::Runtime::CallbackResult IndexFragmentShader(
     Engine::Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::AssetManagement::AssetLoadingContext* inContext);
 
+Engine::Core::Runtime::CallbackResult UnloadFragmentShader(
+    Engine::Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::Pipeline::HashId assetId);
+
 void DisposeFragmentShader(Core::Runtime::ServiceTable *services, SDL_GPUShader *shader);
 
 } // namespace Engine::Extension::RendererModule::Assets
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace Engine::Extension::RendererModule::Assets {
 
 Core::Runtime::CallbackResult ContextualizeMaterial(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* outContext, size_t contextCount);
 Core::Runtime::CallbackResult IndexMaterial(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* inContext);
+Core::Runtime::CallbackResult UnloadMaterial(Core::Runtime::ServiceTable *services, void *moduleState, Core::Pipeline::HashId assetId);
 
 struct ConfiguredUniform
 {
@@ -34,6 +35,9 @@ struct Material
     size_t VertUniformCount;
     size_t FragUniformOffset;
     size_t FragUniformCount;
+
+    // false when the header points into the mapped asset archive
+    bool OwnsHeader;
 };
 
 // sort by prototype id first, then asset id
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EngineCore/AssetManagement/asset_loading_context.h"
+#include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/fwd.h"
 #include "SDL3/SDL_gpu.h"
@@ -12,9 +13,13 @@ struct StaticMesh
     SDL_GPUBuffer* IndexBuffer;
     unsigned int IndexCount;
     SDL_GPUBuffer* VertexBuffer;
+
+    // vertex and index buffers together
+    size_t GpuBytes;
 };
 
 Core::Runtime::CallbackResult ContextualizeStaticMesh(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* outContext, size_t contextCount);
 Core::Runtime::CallbackResult IndexStaticMesh(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* inContext);
+Core::Runtime::CallbackResult UnloadStaticMesh(Core::Runtime::ServiceTable *services, void *moduleState, Core::Pipeline::HashId assetId);
 }
 
@@ -12,7 +12,9 @@
 namespace Engine::Extension::RendererModule::Assets {
 
 Core::Runtime::CallbackResult ContextualizeRenderPipeline(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* outContext, size_t contextCount);
+Core::Runtime::CallbackResult ProcessRenderPipeline(const Core::Runtime::ServiceTable *services, const void *moduleState, Core::AssetManagement::AssetLoadingContext* inContext, void* loadedData);
 Core::Runtime::CallbackResult IndexRenderPipeline(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* inContext);
+Core::Runtime::CallbackResult UnloadRenderPipeline(Core::Runtime::ServiceTable *services, void *moduleState, Core::Pipeline::HashId assetId);
 
 enum class DynamicUniformIdentifier : unsigned char
 {
@@ -68,6 +70,9 @@ struct RenderPipeline
 
     InjectedDataAddress DynamicVertStorageBuffer;
     InjectedDataAddress DynamicFragStorageBuffer;
+
+    // false when the header points into the mapped asset archive
+    bool OwnsHeader;
 };
 
 // renderer pipelines are only sorted based on their asset id
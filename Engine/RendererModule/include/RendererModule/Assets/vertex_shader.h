@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EngineCore/AssetManagement/asset_loading_context.h"
+#include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Runtime/crash_dump.h"
 #include "EngineCore/Runtime/fwd.h"
 
@@ -8,5 +9,6 @@ namespace Engine::Extension::RendererModule::Assets {
 
 Core::Runtime::CallbackResult ContextualizeVertexShader(Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::AssetManagement::AssetLoadingContext* outContext, size_t contextCount);
 Core::Runtime::CallbackResult IndexVertexShader(Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::AssetManagement::AssetLoadingContext* inContext);
+Core::Runtime::CallbackResult UnloadVertexShader(Core::Runtime::ServiceTable *services, void *moduleState, Core::Pipeline::HashId assetId);
 
 }
\ No newline at end of file
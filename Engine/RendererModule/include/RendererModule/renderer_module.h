@@ -2,6 +2,7 @@
 
 #include "EngineCore/Containers/Uniform/sorted_array.h"
 #include "EngineCore/Logging/logger.h"
+#include "EngineCore/Runtime/memory_tracker.h"
 #include "EngineCore/Runtime/service_table.h"
 #include "RendererModule/Assets/mesh.h"
 #include "RendererModule/Assets/material.h"
@@ -31,6 +32,9 @@ public:
     SDL_GPUBuffer* EmptyStorageBuffer;
     Core::Logging::Logger Logger;
 
+    // GPU buffers and heap blobs of the module are counted against this
+    Core::Runtime::MemoryOwner MemoryOwner;
+
     // shaders - ehh these are rarely used paths they can stay fragmented
     std::unordered_map<Core::Pipeline::HashId, SDL_GPUShader*> FragmentShaders;
     std::unordered_map<Core::Pipeline::HashId, SDL_GPUShader*> VertexShaders;
@@ -51,6 +55,7 @@ public:
     // dynamic lighting (they are insanely expensive to update)
     std::vector<RendererModule::Components::DirectionalLight> DirectionalLights;
     SDL_GPUBuffer* DirectionalLightBuffer;
+    size_t DirectionalLightBufferSize;
 
     RendererModuleState(Core::Runtime::ServiceTable* services);
 };
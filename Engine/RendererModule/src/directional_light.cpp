@@ -8,6 +8,7 @@
 #include <EngineCore/Runtime/crash_dump.h>
 #include <EngineCore/Runtime/service_table.h>
 #include <EngineCore/Runtime/graphics_layer.h>
+#include <EngineCore/Runtime/memory_tracker.h>
 
 #include <SDL3/SDL_gpu.h>
 #include <md5.h>
@@ -67,6 +68,13 @@ Engine::Core::Runtime::CallbackResult Components::LoadDirectionalLight(size_t co
         state->DirectionalLights.push_back(stream.Read<DirectionalLight>());
     }
 
+    uint32_t directionalLightBufferSize = (uint32_t)(sizeof(DirectionalLight) * state->DirectionalLights.size());
+    if (services->GraphicsLayer->IsHeadless())
+    {
+        services->GraphicsLayer->RecordUpload(directionalLightBufferSize);
+        return Core::Runtime::CallbackSuccess();
+    }
+
     // TODO: 1. move the buffer upload logic into graphics layer; 2. add error handling, crash the app whenever SDL is reporting error
 
     // adjust GPU buffer
@@ -74,11 +82,10 @@ Engine::Core::Runtime::CallbackResult Components::LoadDirectionalLight(size_t co
     if (state->DirectionalLightBuffer != nullptr)
     {
         SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), state->DirectionalLightBuffer);
+        services->MemoryTracker->TrackFree(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, state->DirectionalLightBufferSize);
         state->DirectionalLightBuffer = nullptr;
     }
 
-    uint32_t directionalLightBufferSize = (uint32_t)(sizeof(DirectionalLight) * state->DirectionalLights.size());
-
     SDL_GPUBufferCreateInfo createInfo {
         SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
         directionalLightBufferSize
@@ -135,5 +142,8 @@ Engine::Core::Runtime::CallbackResult Components::LoadDirectionalLight(size_t co
     SDL_ReleaseGPUTransferBuffer(services->GraphicsLayer->GetDevice(), transferBuffer);
 
     state->DirectionalLightBuffer = directionalLightBuffer;
+    state->DirectionalLightBufferSize = directionalLightBufferSize;
+    if (directionalLightBuffer != nullptr)
+        services->MemoryTracker->TrackAllocation(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, directionalLightBufferSize);
     return Core::Runtime::CallbackSuccess();
 }
\ No newline at end of file
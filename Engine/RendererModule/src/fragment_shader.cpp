@@ -53,6 +53,13 @@ Engine::Core::Runtime::CallbackResult Assets::IndexFragmentShader(
     // load a prefixed length
     size_t codeLength = stream.Read<size_t>();
 
+    // pipelines only need to find the shader by id when there is no device to compile for
+    if (services->GraphicsLayer->IsHeadless())
+    {
+        state->FragmentShaders[inContext->AssetId] = nullptr;
+        return CallbackSuccess();
+    }
+
     // compile shader
     SDL_GPUShaderCreateInfo shaderInfo = {codeLength,
                                             (unsigned char*)stream.Buffer + stream.Cursor,
@@ -74,4 +81,21 @@ Engine::Core::Runtime::CallbackResult Assets::IndexFragmentShader(
 
     state->FragmentShaders[inContext->AssetId] = newShader;
     return CallbackSuccess();
-}
\ No newline at end of file
+}
+
+Engine::Core::Runtime::CallbackResult Assets::UnloadFragmentShader(
+    Engine::Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::Pipeline::HashId assetId)
+{
+    RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
+
+    // pipelines compiled from this shader keep working, the device doesn't need the shader after pipeline creation
+    auto foundShader = state->FragmentShaders.find(assetId);
+    if (foundShader == state->FragmentShaders.end())
+        return Engine::Core::Runtime::CallbackSuccess();
+
+    if (foundShader->second != nullptr)
+        SDL_ReleaseGPUShader(services->GraphicsLayer->GetDevice(), foundShader->second);
+
+    state->FragmentShaders.erase(foundShader);
+    return Engine::Core::Runtime::CallbackSuccess();
+}
@@ -23,6 +23,12 @@ Core::Runtime::CallbackResult Assets::ContextualizeMaterial(Core::Runtime::Servi
             state->Logger.Information("Material {} is already loaded.", outContext[i].AssetId);
             outContext[i].Buffer.Type = Core::AssetManagement::LoadBufferType::Invalid;
         }
+        else if (outContext[i].MappedSource != nullptr)
+        {
+            // materials are never written after loading, read them straight from the archive
+            outContext[i].Buffer.Type = Engine::Core::AssetManagement::LoadBufferType::MappedBuffer;
+            outContext[i].Buffer.Location.MappedBuffer = outContext[i].MappedSource;
+        }
         else 
         {
             outContext[i].Buffer.Type = Engine::Core::AssetManagement::LoadBufferType::ModuleBuffer;
@@ -32,9 +38,9 @@ Core::Runtime::CallbackResult Assets::ContextualizeMaterial(Core::Runtime::Servi
     // distribute out the pointers
     for (size_t i = 0; i < contextCount; i++)
     {
-        if (outContext[i].Buffer.Type == Engine::Core::AssetManagement::LoadBufferType::Invalid)
+        if (outContext[i].Buffer.Type != Engine::Core::AssetManagement::LoadBufferType::ModuleBuffer)
             continue;
-        outContext[i].Buffer.Location.ModuleBuffer = services->HeapAllocator->Allocate(outContext[i].SourceSize);
+        outContext[i].Buffer.Location.ModuleBuffer = services->HeapAllocator->Allocate(outContext[i].SourceSize, state->MemoryOwner);
     }
 
     // allocate space in the index
@@ -48,7 +54,7 @@ Core::Runtime::CallbackResult Assets::IndexMaterial(Core::Runtime::ServiceTable
 {
     RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
 
-    Assets::MaterialHeader *header = static_cast<Assets::MaterialHeader*>(inContext->Buffer.Location.ModuleBuffer);
+    Assets::MaterialHeader *header = static_cast<Assets::MaterialHeader*>(Engine::Core::AssetManagement::GetModuleVisibleBuffer(inContext));
     Utils::Memory::MemStreamLite stream = { SkipHeader(header), 0 };
 
     size_t vertUniformCount = stream.Read<size_t>();
@@ -65,9 +71,32 @@ Core::Runtime::CallbackResult Assets::IndexMaterial(Core::Runtime::ServiceTable
         vertUniformOffset,
         vertUniformCount,
         fragUniformOffset,
-        fragUniformCount
+        fragUniformCount,
+        inContext->Buffer.Type == Core::AssetManagement::LoadBufferType::ModuleBuffer
     };
     state->MaterialIndex.Replace(material);
     
     return Core::Runtime::CallbackSuccess();
-}
\ No newline at end of file
+}
+
+Core::Runtime::CallbackResult Assets::UnloadMaterial(Core::Runtime::ServiceTable *services, void *moduleState, Core::Pipeline::HashId assetId)
+{
+    RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
+    state->LoadedMaterials.Remove(assetId);
+
+    // the index is sorted by prototype first, without the header at hand the material has to be looked for
+    for (size_t i = 0; i < state->MaterialIndex.GetCount(); i++)
+    {
+        Assets::Material* material = state->MaterialIndex.PtrAt(i);
+        if (material->Id != assetId)
+            continue;
+
+        if (material->OwnsHeader)
+            services->HeapAllocator->Deallocate(material->Header);
+
+        state->MaterialIndex.RemoveAt(i);
+        break;
+    }
+
+    return Core::Runtime::CallbackSuccess();
+}
@@ -7,6 +7,8 @@
 
 #include "EngineCore/Runtime/service_table.h"
 #include "EngineCore/Runtime/graphics_layer.h"
+#include "EngineCore/Runtime/memory_tracker.h"
+#include "EngineCore/Runtime/transient_allocator.h"
 #include "SDL3/SDL_error.h"
 #include "SDL3/SDL_gpu.h"
 
@@ -22,12 +24,19 @@ Core::Runtime::CallbackResult Assets::ContextualizeStaticMesh(Core::Runtime::Ser
     // allocate GPU memory
     for (size_t i = 0; i < contextCount; i++)
     {
-        if (!state->StaticMeshes.try_emplace(outContext[i].AssetId, StaticMesh{nullptr, 0, nullptr}).second 
+        if (!state->StaticMeshes.try_emplace(outContext[i].AssetId, StaticMesh{nullptr, 0, nullptr, 0}).second 
             && !outContext[i].ReplaceExisting)
         {
             state->Logger.Information("Static mesh {} is already loaded.", outContext[i].AssetId);
             outContext[i].Buffer.Type = Core::AssetManagement::LoadBufferType::Invalid;
         }
+        else if (services->GraphicsLayer->IsHeadless())
+        {
+            // still read the file so loading costs the same, the indexer only keeps the index count
+            outContext[i].Buffer.Type = Core::AssetManagement::LoadBufferType::TransientBuffer;
+            outContext[i].Buffer.Location.TransientBufferSize = outContext[i].SourceSize;
+            outContext[i].UserData = nullptr;
+        }
         else 
         {
             SDL_GPUTransferBufferCreateInfo transBufferCreateInfo 
@@ -69,10 +78,34 @@ Core::Runtime::CallbackResult Assets::ContextualizeStaticMesh(Core::Runtime::Ser
 }
 
 
+static Core::Runtime::CallbackResult IndexHeadlessStaticMesh(Core::Runtime::ServiceTable *services, RendererModuleState* state, Core::AssetManagement::AssetLoadingContext* inContext)
+{
+    void* buffer = services->TransientAllocator->GetBuffer(inContext->Buffer.Location.TransientBufferId);
+    if (buffer == nullptr)
+    {
+        state->Logger.Error("Failed to load static mesh {} because transient buffer is invalid.", inContext->AssetId);
+        return Core::Runtime::CallbackSuccess();
+    }
+
+    Utils::Memory::MemStreamLite stream = { buffer, 0 };
+    unsigned int vertexCount = stream.Read<unsigned int>();
+    stream.Seek(stream.GetPosition() + vertexCount * sizeof(Data::Vertex));
+    unsigned int indexCount = stream.Read<unsigned int>();
+
+    services->GraphicsLayer->RecordUpload(vertexCount * sizeof(Data::Vertex));
+    services->GraphicsLayer->RecordUpload(indexCount * sizeof(int));
+
+    state->StaticMeshes[inContext->AssetId] = Assets::StaticMesh { nullptr, indexCount, nullptr, 0 };
+    return Core::Runtime::CallbackSuccess();
+}
+
 Core::Runtime::CallbackResult Assets::IndexStaticMesh(Core::Runtime::ServiceTable *services, void *moduleState, Core::AssetManagement::AssetLoadingContext* inContext)
 {
     RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
 
+    if (services->GraphicsLayer->IsHeadless())
+        return IndexHeadlessStaticMesh(services, state, inContext);
+
     void* mappedTransferBuffer = inContext->Buffer.Location.ModuleBuffer;
     SDL_GPUTransferBuffer* transferBuffer = static_cast<SDL_GPUTransferBuffer*>(inContext->UserData);
 
@@ -189,13 +222,18 @@ Core::Runtime::CallbackResult Assets::IndexStaticMesh(Core::Runtime::ServiceTabl
     SDL_SubmitGPUCommandBuffer(uploadCmdBuffer);
     SDL_ReleaseGPUTransferBuffer(services->GraphicsLayer->GetDevice(), transferBuffer);
 
-    Assets::StaticMesh mesh { indexBuffer, indexCount, vertexBuffer };
+    size_t gpuBytes = (vertexBuffer != nullptr ? vertexBufferSize : 0) + (indexBuffer != nullptr ? indexBufferSize : 0);
+    Assets::StaticMesh mesh { indexBuffer, indexCount, vertexBuffer, gpuBytes };
+    if (gpuBytes > 0)
+        services->MemoryTracker->TrackAllocation(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, gpuBytes);
 
     auto existingMesh = state->StaticMeshes.try_emplace(inContext->AssetId, mesh);
 
     // clean up the old value if needed
     if (!existingMesh.second)
     {
+        if (existingMesh.first->second.GpuBytes > 0)
+            services->MemoryTracker->TrackFree(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, existingMesh.first->second.GpuBytes);
         if (existingMesh.first->second.IndexBuffer != nullptr)
         {
             SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), existingMesh.first->second.IndexBuffer);
@@ -209,4 +247,35 @@ Core::Runtime::CallbackResult Assets::IndexStaticMesh(Core::Runtime::ServiceTabl
     }
 
     return Core::Runtime::CallbackSuccess();
-}
\ No newline at end of file
+}
+
+Core::Runtime::CallbackResult Assets::UnloadStaticMesh(Core::Runtime::ServiceTable *services, void *moduleState, Core::Pipeline::HashId assetId)
+{
+    RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
+
+    auto foundMesh = state->StaticMeshes.find(assetId);
+    if (foundMesh == state->StaticMeshes.end())
+        return Core::Runtime::CallbackSuccess();
+
+    // mesh renderers cache the buffers, make them look the mesh up again in case it's loaded back later
+    for (size_t i = 0; i < state->MeshRenderers.GetCount(); i++)
+    {
+        Components::MeshRenderer* meshRenderer = state->MeshRenderers.PtrAt(i);
+        if (meshRenderer->Mesh != assetId)
+            continue;
+
+        meshRenderer->VertexBuffer = nullptr;
+        meshRenderer->IndexBuffer = nullptr;
+        meshRenderer->IndexCount = 0;
+    }
+
+    if (foundMesh->second.IndexBuffer != nullptr)
+        SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), foundMesh->second.IndexBuffer);
+    if (foundMesh->second.VertexBuffer != nullptr)
+        SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), foundMesh->second.VertexBuffer);
+    if (foundMesh->second.GpuBytes > 0)
+        services->MemoryTracker->TrackFree(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, foundMesh->second.GpuBytes);
+
+    state->StaticMeshes.erase(foundMesh);
+    return Core::Runtime::CallbackSuccess();
+}
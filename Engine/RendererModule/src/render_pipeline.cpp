@@ -60,6 +60,12 @@ Engine::Core::Runtime::CallbackResult Assets::ContextualizeRenderPipeline(Engine
             state->Logger.Information("Render pipeline {} is already loaded.", outContext[i].AssetId);
             outContext[i].Buffer.Type = Core::AssetManagement::LoadBufferType::Invalid;
         }
+        else if (outContext[i].MappedSource != nullptr)
+        {
+            // pipelines are never written after loading, read them straight from the archive
+            outContext[i].Buffer.Type = Engine::Core::AssetManagement::LoadBufferType::MappedBuffer;
+            outContext[i].Buffer.Location.MappedBuffer = outContext[i].MappedSource;
+        }
         else
         {
             outContext[i].Buffer.Type = Engine::Core::AssetManagement::LoadBufferType::ModuleBuffer;
@@ -69,9 +75,9 @@ Engine::Core::Runtime::CallbackResult Assets::ContextualizeRenderPipeline(Engine
     // distribute out the pointers
     for (size_t i = 0; i < contextCount; i++)
     {
-        if (outContext[i].Buffer.Type == Core::AssetManagement::LoadBufferType::Invalid)
+        if (outContext[i].Buffer.Type != Core::AssetManagement::LoadBufferType::ModuleBuffer)
             continue;
-        outContext[i].Buffer.Location.ModuleBuffer = services->HeapAllocator->Allocate(outContext->SourceSize);
+        outContext[i].Buffer.Location.ModuleBuffer = services->HeapAllocator->Allocate(outContext[i].SourceSize, state->MemoryOwner);
     }
 
     return Engine::Core::Runtime::CallbackSuccess();
@@ -87,28 +93,11 @@ Engine::Extension::RendererModule::Assets::InjectedDataAddress LocateInjectedDat
     return { count, offset};
 }
 
-Engine::Core::Runtime::CallbackResult Assets::IndexRenderPipeline(Engine::Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::AssetManagement::AssetLoadingContext* inContext)
+static SDL_GPUGraphicsPipeline* CreateGpuPipeline(Engine::Core::Runtime::ServiceTable *services, RendererModuleState* state, Engine::Core::Pipeline::HashId assetId, SDL_GPUShader* vertexShader, SDL_GPUShader* fragmentShader)
 {
-    RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
-    Assets::RenderPipelineHeader* header = static_cast<Assets::RenderPipelineHeader*>(inContext->Buffer.Location.ModuleBuffer);
-
-    // find shaders
-    auto foundVertShader = state->VertexShaders.find(header->VertexShader);
-    auto foundFragShader = state->FragmentShaders.find(header->FragmentShader);
-    if (foundVertShader == state->VertexShaders.end() || foundFragShader == state->FragmentShaders.end())
-    {
-        state->Logger.Error("Failed to find shaders for render pipeline {}.", inContext->AssetId);
-
-        // this asset can't really be deleted at this moment
-        Assets::RenderPipeline pipeline = { inContext->AssetId, nullptr, header };
-        state->PipelineIndex.InsertRange(&pipeline, 1);
-        return Core::Runtime::CallbackSuccess();
-    }
-
-    // create gpu pipeline
     SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo {
-        foundVertShader->second,
-        foundFragShader->second,
+        vertexShader,
+        fragmentShader,
         vertexInputState,
         SDL_GPUPrimitiveType::SDL_GPU_PRIMITIVETYPE_TRIANGLELIST
     };
@@ -132,12 +121,51 @@ Engine::Core::Runtime::CallbackResult Assets::IndexRenderPipeline(Engine::Core::
         true
     };
 
-    auto gpuPipeline = SDL_CreateGPUGraphicsPipeline(services->GraphicsLayer->GetDevice(), &pipelineCreateInfo);
+    SDL_GPUGraphicsPipeline* gpuPipeline = SDL_CreateGPUGraphicsPipeline(services->GraphicsLayer->GetDevice(), &pipelineCreateInfo);
     if (gpuPipeline == nullptr)
     {
-        state->Logger.Error("Failed to create gpu graphics pipeline for render pipeline {}, detail:", inContext->AssetId, SDL_GetError());
+        state->Logger.Error("Failed to create gpu graphics pipeline for render pipeline {}, detail:", assetId, SDL_GetError());
     }
 
+    return gpuPipeline;
+}
+
+Engine::Core::Runtime::CallbackResult Assets::ProcessRenderPipeline(const Engine::Core::Runtime::ServiceTable *services, const void *moduleState, Engine::Core::AssetManagement::AssetLoadingContext* inContext, void* loadedData)
+{
+    // the pipeline is compiled against its shaders, so they have to be indexed first
+    const Assets::RenderPipelineHeader* header = static_cast<const Assets::RenderPipelineHeader*>(loadedData);
+    if (header == nullptr)
+        return Engine::Core::Runtime::CallbackSuccess();
+
+    Engine::Core::AssetManagement::AddDependency(inContext, header->VertexShader);
+    Engine::Core::AssetManagement::AddDependency(inContext, header->FragmentShader);
+    return Engine::Core::Runtime::CallbackSuccess();
+}
+
+Engine::Core::Runtime::CallbackResult Assets::IndexRenderPipeline(Engine::Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::AssetManagement::AssetLoadingContext* inContext)
+{
+    RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
+    Assets::RenderPipelineHeader* header = static_cast<Assets::RenderPipelineHeader*>(Engine::Core::AssetManagement::GetModuleVisibleBuffer(inContext));
+
+    // find shaders
+    auto foundVertShader = state->VertexShaders.find(header->VertexShader);
+    auto foundFragShader = state->FragmentShaders.find(header->FragmentShader);
+    if (foundVertShader == state->VertexShaders.end() || foundFragShader == state->FragmentShaders.end())
+    {
+        state->Logger.Error("Failed to find shaders for render pipeline {}.", inContext->AssetId);
+
+        // this asset can't really be deleted at this moment
+        Assets::RenderPipeline pipeline = { inContext->AssetId, nullptr, header };
+        pipeline.OwnsHeader = inContext->Buffer.Type == Core::AssetManagement::LoadBufferType::ModuleBuffer;
+        state->PipelineIndex.InsertRange(&pipeline, 1);
+        return Core::Runtime::CallbackSuccess();
+    }
+
+    // create gpu pipeline, headless runs keep the pipeline around without one so its draws can still be counted
+    SDL_GPUGraphicsPipeline* gpuPipeline = nullptr;
+    if (!services->GraphicsLayer->IsHeadless())
+        gpuPipeline = CreateGpuPipeline(services, state, inContext->AssetId, foundVertShader->second, foundFragShader->second);
+
     // read the file
     Utils::Memory::MemStreamLite stream { SkipHeader(header), 0 };
     Assets::RenderPipeline pipeline = { 
@@ -152,9 +180,30 @@ Engine::Core::Runtime::CallbackResult Assets::IndexRenderPipeline(Engine::Core::
         LocateInjectedDataFromStream<InjectedStorageBuffer>(stream),
         LocateInjectedDataFromStream<InjectedStorageBuffer>(stream),
         LocateInjectedDataFromStream<InjectedStorageBuffer>(stream),
+        inContext->Buffer.Type == Core::AssetManagement::LoadBufferType::ModuleBuffer
     };
 
     // NOTE: non-replace behavior would have been intercepted beforehand
     state->PipelineIndex.Replace(pipeline);
     return Engine::Core::Runtime::CallbackSuccess();
 }
+
+Engine::Core::Runtime::CallbackResult Assets::UnloadRenderPipeline(Engine::Core::Runtime::ServiceTable *services, void *moduleState, Engine::Core::Pipeline::HashId assetId)
+{
+    RendererModuleState* state = static_cast<RendererModuleState*>(moduleState);
+
+    Assets::RenderPipeline key { assetId };
+    size_t position = state->PipelineIndex.Search(key);
+    Assets::RenderPipeline* pipeline = state->PipelineIndex.PtrAt(position);
+    if (pipeline == nullptr)
+        return Engine::Core::Runtime::CallbackSuccess();
+
+    // the device defers the actual release until frames already submitted are done with the pipeline
+    if (pipeline->GpuPipeline != nullptr)
+        SDL_ReleaseGPUGraphicsPipeline(services->GraphicsLayer->GetDevice(), pipeline->GpuPipeline);
+    if (pipeline->OwnsHeader)
+        services->HeapAllocator->Deallocate(pipeline->Header);
+
+    state->PipelineIndex.RemoveAt(position);
+    return Engine::Core::Runtime::CallbackSuccess();
+}
@@ -20,6 +20,7 @@
 #include <EngineCore/Pipeline/module_definition.h>
 #include <EngineCore/Runtime/service_table.h>
 #include <EngineCore/Runtime/graphics_layer.h>
+#include <EngineCore/Runtime/heap_allocator.h>
 #include <EngineCore/Pipeline/component_definition.h>
 #include <EngineCore/Pipeline/engine_callback.h>
 #include <EngineCore/Runtime/module_manager.h>
@@ -50,11 +51,13 @@ RendererModuleState::RendererModuleState(Core::Runtime::ServiceTable* services)
     : RootModule(services->ModuleManager->GetRootModule()),
     EmptyStorageBuffer(CreaetEmptyStorageBuffer(services->GraphicsLayer)),
     Logger(services->LoggerService->CreateLogger("RendererModule")),
+    MemoryOwner(services->MemoryTracker->RegisterOwner("RendererModule")),
     PipelineIndex(services->ContainerFactory->CreateSortedArray<Assets::RenderPipeline, Assets::RenderPipelineComparer>(16)),
     LoadedMaterials(services->ContainerFactory->CreateSortedArray<Core::Pipeline::HashId>(16)),
     MaterialIndex(services->ContainerFactory->CreateSortedArray<Assets::Material, Assets::MaterialComparer>(16)),
     MeshRenderers(services->ContainerFactory->CreateSortedArray<Components::MeshRenderer, Components::MeshRendererComparer>(16)),
-    DirectionalLightBuffer(nullptr)
+    DirectionalLightBuffer(nullptr),
+    DirectionalLightBufferSize(0)
 {}
 
 static void* InitRendererModule(Core::Runtime::ServiceTable* services)
@@ -68,20 +71,32 @@ static void DisposeRendererModule(Core::Runtime::ServiceTable *services, void *m
 
     SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), state->EmptyStorageBuffer);
     SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), state->DirectionalLightBuffer);
+    if (state->DirectionalLightBuffer != nullptr)
+        services->MemoryTracker->TrackFree(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, state->DirectionalLightBufferSize);
 
     for (const auto& mesh : state->StaticMeshes)
     {
         SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), mesh.second.IndexBuffer);
         SDL_ReleaseGPUBuffer(services->GraphicsLayer->GetDevice(), mesh.second.VertexBuffer);
+        if (mesh.second.GpuBytes > 0)
+            services->MemoryTracker->TrackFree(Core::Runtime::MemorySubsystem::GpuBuffers, state->MemoryOwner, mesh.second.GpuBytes);
     }
 
     for (size_t i = 0; i < state->PipelineIndex.GetCount(); i++)
     {
+        if (state->PipelineIndex.PtrAt(i)->OwnsHeader)
+            services->HeapAllocator->Deallocate(state->PipelineIndex.PtrAt(i)->Header);
         if (state->PipelineIndex.PtrAt(i)->GpuPipeline == nullptr)
             continue;
         SDL_ReleaseGPUGraphicsPipeline(services->GraphicsLayer->GetDevice(), state->PipelineIndex.PtrAt(i)->GpuPipeline);
     }
 
+    for (size_t i = 0; i < state->MaterialIndex.GetCount(); i++)
+    {
+        if (state->MaterialIndex.PtrAt(i)->OwnsHeader)
+            services->HeapAllocator->Deallocate(state->MaterialIndex.PtrAt(i)->Header);
+    }
+
     for (const auto& shader : state->FragmentShaders)
     {
         if (shader.second == nullptr)
@@ -98,6 +113,7 @@ static void DisposeRendererModule(Core::Runtime::ServiceTable *services, void *m
 
     // destroy the borrowed containers
     state->MaterialIndex.Destroy();
+    state->LoadedMaterials.Destroy();
     state->PipelineIndex.Destroy();
     state->MeshRenderers.Destroy();
 
@@ -106,9 +122,12 @@ static void DisposeRendererModule(Core::Runtime::ServiceTable *services, void *m
 
 static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* services, void* moduleState) 
 {
+    // the root module decides whether this is the live state or a snapshot of the last simulated frame
+    const Core::Runtime::RootModuleState* rootModule = services->ModuleManager->GetRootModule();
+
     // get the primary engine camera
     int cameraEntity = -1;
-    for (const Core::Ecs::Components::Camera& candidate : services->ModuleManager->GetRootModule()->CameraComponents) 
+    for (const Core::Ecs::Components::Camera& candidate : rootModule->GetRenderCameras()) 
     {
         if (candidate.IsPrimary)
         {
@@ -120,12 +139,14 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
     // abort if primary camera doesn't exist or it doesn't have a valid spatial relation
     if (cameraEntity == -1)
         return Core::Runtime::CallbackSuccess();
-    auto foundCameraTransform = services->ModuleManager->GetRootModule()->SpatialComponents.find(cameraEntity);
-    if (foundCameraTransform == services->ModuleManager->GetRootModule()->SpatialComponents.end())
+
+    // render in between the last two simulation steps
+    Core::Ecs::Components::SpatialRelation cameraTransform;
+    if (!rootModule->GetRenderSpatial(cameraEntity, &cameraTransform))
         return Core::Runtime::CallbackSuccess();
 
     // calculate view matrix
-    glm::mat4 viewMatrix = glm::inverse(foundCameraTransform->second.Transform());
+    glm::mat4 viewMatrix = glm::inverse(cameraTransform.Transform());
 
     // calculate projection matrix
     glm::mat4 projectMatrix =
@@ -141,6 +162,9 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
     SDL_GPURenderPass* pass = services->GraphicsLayer->AddRenderPass();
     SDL_GPUCommandBuffer* commandBuffer = services->GraphicsLayer->GetCurrentCommandBuffer();
 
+    // headless runs walk the same scene but only count the draws, nothing on the GPU side exists
+    bool headless = services->GraphicsLayer->IsHeadless();
+
     // cache the mesh renderer position
     size_t meshRendererPos = 0;
 
@@ -170,9 +194,10 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
         auto currentPipeline = state->PipelineIndex.PtrAt(pipelinePosition);
 
         // skip a pipeline if it's not available
-        if (currentPipeline->GpuPipeline == nullptr)
+        if (currentPipeline->GpuPipeline == nullptr && !headless)
             continue;
-        SDL_BindGPUGraphicsPipeline(pass, currentPipeline->GpuPipeline);
+        if (!headless)
+            SDL_BindGPUGraphicsPipeline(pass, currentPipeline->GpuPipeline);
 
         // find the first material that matches the prototype id
         size_t materialPos = state->MaterialIndex.GetCount();
@@ -210,7 +235,7 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
         // static injections
         // NOTE: we currently don't inject any static uniforms
         Assets::InjectedStorageBuffer* staticVertStorageBuffers = (Assets::InjectedStorageBuffer*)(loadedPipelineData + currentPipeline->StaticVertStorageBuffer.Offset);
-        for (size_t i = 0; i < currentPipeline->StaticVertStorageBuffer.Count; i++) 
+        for (size_t i = 0; i < currentPipeline->StaticVertStorageBuffer.Count && !headless; i++) 
         {
             switch (staticVertStorageBuffers[i].Identifier) 
             {
@@ -221,7 +246,7 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
         }
 
         Assets::InjectedStorageBuffer* staticFragStorageBuffers = (Assets::InjectedStorageBuffer*)(loadedPipelineData + currentPipeline->StaticFragStorageBuffer.Offset);
-        for (size_t i = 0; i < currentPipeline->StaticFragStorageBuffer.Count; i++) 
+        for (size_t i = 0; i < currentPipeline->StaticFragStorageBuffer.Count && !headless; i++) 
         {
             switch (staticFragStorageBuffers[i].Identifier)
             {
@@ -261,7 +286,9 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
             {
                 // skip this mesh renderer if the target mesh isn't in yet
                 auto foundMesh = state->StaticMeshes.find(currentMeshRenderer->Mesh);
-                if (foundMesh == state->StaticMeshes.end() || foundMesh->second.IndexBuffer == nullptr || foundMesh->second.VertexBuffer == nullptr)
+                if (foundMesh == state->StaticMeshes.end())
+                    continue;
+                if (!headless && (foundMesh->second.IndexBuffer == nullptr || foundMesh->second.VertexBuffer == nullptr))
                     continue;
 
                 currentMeshRenderer->IndexBuffer = foundMesh->second.IndexBuffer;
@@ -270,7 +297,7 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
             }
 
             // reapply material if it's changed
-            if (previouslyActiveMaterialPos != materialPos)
+            if (previouslyActiveMaterialPos != materialPos && !headless)
             {
                 previouslyActiveMaterialPos = materialPos;
 
@@ -301,12 +328,18 @@ static Core::Runtime::CallbackResult RenderUpdate(Core::Runtime::ServiceTable* s
             }
 
             // load the MVP, skip if the renderer has no spatial relation
-            auto foundModelSpatialRelation = services->ModuleManager->GetRootModule()->SpatialComponents.find(currentMeshRenderer->Entity);
-            if (foundModelSpatialRelation == services->ModuleManager->GetRootModule()->SpatialComponents.end())
+            Core::Ecs::Components::SpatialRelation modelSpatialRelation;
+            if (!rootModule->GetRenderSpatial(currentMeshRenderer->Entity, &modelSpatialRelation))
                 continue;
 
             // compute MVP from scene components
-            glm::mat4 modelMatrix = foundModelSpatialRelation->second.Transform();
+            glm::mat4 modelMatrix = modelSpatialRelation.Transform();
+
+            if (headless)
+            {
+                services->GraphicsLayer->RecordDrawCall(currentMeshRenderer->IndexCount);
+                continue;
+            }
 
             // bind dynamic injections (only uniforms rn)
             auto dynamicVertexUniforms = (Assets::InjectedUniform*)(loadedPipelineData + currentPipeline->DynamicVertUniform.Offset);
@@ -367,37 +400,51 @@ Engine::Core::Pipeline::ModuleDefinition Engine::Extension::RendererModule::GetM
         {
             HASH_NAME("VertexShader"),
             Assets::ContextualizeVertexShader,
-            Assets::IndexVertexShader
+            Assets::IndexVertexShader,
+            nullptr,
+            Assets::UnloadVertexShader
         },
         {
             HASH_NAME("FragmentShader"),
             Assets::ContextualizeFragmentShader,
-            Assets::IndexFragmentShader
+            Assets::IndexFragmentShader,
+            nullptr,
+            Assets::UnloadFragmentShader
         },
         {
             HASH_NAME("SlangVertexShader"),
             Assets::ContextualizeVertexShader,
-            Assets::IndexVertexShader
+            Assets::IndexVertexShader,
+            nullptr,
+            Assets::UnloadVertexShader
         },
         {
             HASH_NAME("SlangFragmentShader"),
             Assets::ContextualizeFragmentShader,
-            Assets::IndexFragmentShader
+            Assets::IndexFragmentShader,
+            nullptr,
+            Assets::UnloadFragmentShader
         },
         {
             HASH_NAME("RenderPipeline"),
             Assets::ContextualizeRenderPipeline,
-            Assets::IndexRenderPipeline
+            Assets::IndexRenderPipeline,
+            Assets::ProcessRenderPipeline,
+            Assets::UnloadRenderPipeline
         },
         {
             HASH_NAME("Material"),
             Assets::ContextualizeMaterial,
-            Assets::IndexMaterial
+            Assets::IndexMaterial,
+            nullptr,
+            Assets::UnloadMaterial
         },
         {
             HASH_NAME("Mesh"),
             Assets::ContextualizeStaticMesh,
             Assets::IndexStaticMesh,
+            nullptr,
+            Assets::UnloadStaticMesh
         }
     };
 
@@ -1,12 +1,25 @@
 #define DEBUG_OR_TEST 0b10
 
-#include <EngineUtils/Memory/FreeList/bucket_allocator.h>
-#include <EngineUtils/Memory/FreeList/compact_allocator.h>
-#include <EngineUtils/Memory/Lifo/unmanaged_stack_allocator.h>
-#include <EngineUtils/Memory/alignment_calc.h>
+#include <EngineCore/AssetManagement/compressed_asset.h>
+#include <EngineCore/Configuration/configuration_provider.h>
+#include <EngineCore/Logging/logger_service.h>
+#include <EngineCore/Runtime/crash_dump.h>
+#include <EngineCore/Runtime/event_manager.h>
+#include <EngineCore/Runtime/event_writer.h>
+#include <EngineCore/Runtime/heap_allocator.h>
+#include <EngineCore/Runtime/service_table.h>
+#include <EngineCore/Runtime/task_graph.h>
+#include <EngineCore/Runtime/task_manager.h>
+#include <EngineCore/Runtime/transient_allocator.h>
+#include <EngineUtils/Compression/block_codec.h>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 #define SE_TEST_RUNTEST(testName)                                                                                      \
@@ -47,112 +60,948 @@ void ResetColor()
     std::cout << "\033[0m";
 }
 
-bool BucketAllocatorTest()
+static Engine::Core::Configuration::ConfigurationProvider s_Configs;
+static Engine::Core::Logging::LoggerService s_LoggerService(s_Configs);
+
+namespace TaskGraphTests {
+
+using namespace Engine::Core::Runtime;
+
+struct Job
+{
+    std::atomic<int>* Clock;
+    int StartedAt = -1;
+    bool Fail = false;
+};
+
+static CallbackResult RunJob(void* state)
+{
+    Job* job = static_cast<Job*>(state);
+    job->StartedAt = job->Clock->fetch_add(1);
+    if (job->Fail)
+        return Crash(__FILE__, __LINE__, "Job failed on purpose.");
+    return CallbackSuccess();
+}
+
+static CallbackResult CountContinuation(void* state)
 {
-    struct Data
+    static_cast<std::atomic<int>*>(state)->fetch_add(1);
+    return CallbackSuccess();
+}
+
+}
+
+bool TaskGraphDiamondTest()
+{
+    using namespace TaskGraphTests;
+
+    ServiceTable services {};
+    services.LoggerService = &s_LoggerService;
+    TaskManager taskManager(&services, &s_LoggerService, 3);
+
+    std::atomic<int> clock { 0 };
+    std::atomic<int> continuations { 0 };
+    Job top { &clock }, left { &clock }, right { &clock }, bottom { &clock };
+
+    TaskGraph graph;
+    size_t topId = graph.AddJob(RunJob, &top);
+    size_t leftId = graph.AddJob(RunJob, &left);
+    size_t rightId = graph.AddJob(RunJob, &right);
+    size_t bottomId = graph.AddJob(RunJob, &bottom);
+    graph.AddDependency(topId, leftId);
+    graph.AddDependency(topId, rightId);
+    graph.AddDependency(leftId, bottomId);
+    graph.AddDependency(rightId, bottomId);
+    graph.SetContinuation(topId, CountContinuation, &continuations);
+
+    // a graph can be run again once the previous run completed
+    for (int run = 0; run < 2; run++)
     {
-        int a = 0;
-        int b = 0;
-    };
+        clock = 0;
+        if (graph.Run(&taskManager).has_value())
+            return false;
+
+        if (top.StartedAt != 0 || bottom.StartedAt != 3)
+            return false;
+        if (left.StartedAt < 1 || left.StartedAt > 2 || right.StartedAt < 1 || right.StartedAt > 2)
+            return false;
+    }
 
-    std::cout << "sizeof(BucketAllocator) = " << sizeof(Engine::Utils::Memory::FreeList::BucketAllocator<Data>)
-              << std::endl;
+    return continuations == 2;
+}
+
+bool TaskGraphCycleTest()
+{
+    using namespace TaskGraphTests;
+
+    ServiceTable services {};
+    services.LoggerService = &s_LoggerService;
+    TaskManager taskManager(&services, &s_LoggerService, 1);
 
-    Engine::Utils::Memory::FreeList::BucketAllocator<Data> allocator;
+    std::atomic<int> clock { 0 };
+    Job root { &clock }, first { &clock }, second { &clock };
 
-    const size_t TRIALS = 1000000;
-    std::vector<size_t> ids;
-    ids.reserve(TRIALS);
+    // the root can start, the two jobs waiting on each other never can
+    TaskGraph graph;
+    size_t rootId = graph.AddJob(RunJob, &root);
+    size_t firstId = graph.AddJob(RunJob, &first);
+    size_t secondId = graph.AddJob(RunJob, &second);
+    graph.AddDependency(rootId, firstId);
+    graph.AddDependency(firstId, secondId);
+    graph.AddDependency(secondId, firstId);
+
+    // rejected before anything runs
+    if (!graph.Run(&taskManager).has_value())
+        return false;
+
+    return clock == 0 && root.StartedAt == -1;
+}
 
-    for (size_t i = 0; i < TRIALS; i++)
+bool TaskGraphFailureTest()
+{
+    using namespace TaskGraphTests;
+
+    ServiceTable services {};
+    services.LoggerService = &s_LoggerService;
+    TaskManager taskManager(&services, &s_LoggerService, 2);
+
+    std::atomic<int> clock { 0 };
+    std::atomic<int> continuations { 0 };
+    Job first { &clock }, second { &clock }, third { &clock };
+    first.Fail = true;
+
+    TaskGraph graph;
+    size_t firstId = graph.AddJob(RunJob, &first);
+    size_t secondId = graph.AddJob(RunJob, &second);
+    size_t thirdId = graph.AddJob(RunJob, &third);
+    graph.AddDependency(firstId, secondId);
+    graph.AddDependency(secondId, thirdId);
+    graph.SetContinuation(firstId, CountContinuation, &continuations);
+
+    // the failure reaches the caller, the successors and the continuation of the failed job never run
+    CallbackResult result = graph.Run(&taskManager);
+    if (!result.has_value() || result->ErrorDetail.find("on purpose") == std::string::npos)
+        return false;
+    if (second.StartedAt != -1 || third.StartedAt != -1 || continuations != 0)
+        return false;
+
+    // the failure doesn't stick to the next run
+    first.Fail = false;
+    clock = 0;
+    if (graph.Run(&taskManager).has_value())
+        return false;
+
+    return first.StartedAt == 0 && second.StartedAt == 1 && third.StartedAt == 2 && continuations == 1;
+}
+
+bool TransientGroupReuseTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    TransientAllocator allocator(&s_LoggerService, &memoryTracker);
+
+    TransientBufferId first = allocator.CreateBufferGroup(100, 1);
+    void* firstBuffer = allocator.GetBuffer(first);
+    if (first.Parent < 0 || firstBuffer == nullptr)
+        return false;
+    allocator.Return(first);
+
+    // the emptied page starts over for the next group
+    TransientBufferId second = allocator.CreateBufferGroup(100, 1);
+    if (allocator.GetBuffer(second) != firstBuffer || allocator.GetBuffer(first) != nullptr)
+        return false;
+
+    // groups live in the same page one after the other, aligned
+    TransientBufferId third = allocator.CreateBufferGroup(1, 1);
+    if (static_cast<unsigned char*>(allocator.GetBuffer(third)) != static_cast<unsigned char*>(firstBuffer) + 112)
+        return false;
+    allocator.Return(second);
+    allocator.Return(third);
+
+    // returned slots are taken again once the free ones ran out, a stale id doesn't resolve to the group reusing it
+    TransientBufferId reused { -1, 0, 0 };
+    for (int i = 0; i <= TransientAllocator::GroupChunkSize && reused.Parent != first.Parent; i++)
     {
-        ids.push_back(allocator.New({1, 0}));
+        reused = allocator.CreateBufferGroup(16, 1);
+        if (reused.Parent != first.Parent)
+            allocator.Return(reused);
     }
 
-    int total = 0;
+    bool stale = reused.Parent == first.Parent && reused.Generation != first.Generation
+        && allocator.GetBuffer(reused) != nullptr && allocator.GetBuffer(first) == nullptr;
+    allocator.Return(reused);
+    return stale;
+}
+
+bool TransientGroupChildrenTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    TransientAllocator allocator(&s_LoggerService, &memoryTracker);
+
+    // the group stays until its last child is returned, children resolve to their offset
+    TransientBufferId group = allocator.CreateBufferGroup(300, 3);
+    TransientBufferId child = group;
+    child.Child = 200;
+    if (static_cast<unsigned char*>(allocator.GetBuffer(child)) != static_cast<unsigned char*>(allocator.GetBuffer(group)) + 200)
+        return false;
+
+    allocator.Return(group);
+    allocator.Return(group);
+    if (allocator.GetBuffer(child) == nullptr)
+        return false;
+
+    allocator.Return(child);
+    return allocator.GetBuffer(group) == nullptr && allocator.GetBuffer(child) == nullptr;
+}
+
+bool TransientLargeGroupTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    TransientAllocator allocator(&s_LoggerService, &memoryTracker);
+
+    // groups beyond the page size get a page of their own, the current page keeps being used
+    TransientBufferId small = allocator.CreateBufferGroup(64, 1);
+    TransientBufferId large = allocator.CreateBufferGroup(TransientAllocator::PageSize + 1, 1);
+    TransientBufferId next = allocator.CreateBufferGroup(64, 1);
+    unsigned char* largeBuffer = static_cast<unsigned char*>(allocator.GetBuffer(large));
+    if (largeBuffer == nullptr || static_cast<unsigned char*>(allocator.GetBuffer(next)) != static_cast<unsigned char*>(allocator.GetBuffer(small)) + 64)
+        return false;
+
+    largeBuffer[TransientAllocator::PageSize] = 1;
+    allocator.Return(large);
+    allocator.Return(small);
+    allocator.Return(next);
+    return allocator.GetBuffer(large) == nullptr;
+}
 
-    allocator.IterateAll([&total](const Data *cursor) { total += cursor->a; });
+namespace TransientTests {
 
-    assert(total == TRIALS);
+using namespace Engine::Core::Runtime;
 
-    for (size_t id : ids)
+constexpr int GroupsPerBatch = 64;
+
+struct WorkerBatch
+{
+    TransientAllocator* Allocator;
+    unsigned char Seed;
+    TransientBufferId Kept[GroupsPerBatch / 2];
+    bool Valid;
+};
+
+static size_t BatchGroupSize(int index)
+{
+    return 64 + (size_t)index * 48;
+}
+
+// every other group is returned right away on the worker, the rest are left for the main thread
+static CallbackResult AllocateAndReturn(void* state)
+{
+    WorkerBatch* batch = static_cast<WorkerBatch*>(state);
+    batch->Valid = true;
+    for (int i = 0; i < GroupsPerBatch; i++)
     {
-        if (id % 2 == 0)
-            continue;
+        TransientBufferId id = batch->Allocator->CreateBufferGroup(BatchGroupSize(i), 1);
+        unsigned char* buffer = static_cast<unsigned char*>(batch->Allocator->GetBuffer(id));
+        if (buffer == nullptr)
+        {
+            batch->Valid = false;
+            return CallbackSuccess();
+        }
 
-        allocator.Free(id);
+        memset(buffer, batch->Seed, BatchGroupSize(i));
+        if (i % 2 == 0)
+            batch->Kept[i / 2] = id;
+        else
+            batch->Allocator->Return(id);
     }
 
-    total = 0;
-    allocator.IterateAll([&total](const Data *cursor) { total += cursor->a; });
-    assert(total == TRIALS / 2);
+    return CallbackSuccess();
+}
 
-    return true;
 }
 
-bool StackAllocatorTest()
+bool TransientMultiWorkerTest()
 {
-    using namespace Engine::Utils::Memory::Lifo;
+    using namespace TransientTests;
 
-    UnmanagedStackAllocator allocator(16);
+    ServiceTable services {};
+    services.LoggerService = &s_LoggerService;
+    TaskManager taskManager(&services, &s_LoggerService, 4);
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    TransientAllocator allocator(&s_LoggerService, &memoryTracker);
 
-    size_t offsetOne = allocator.Allocate(16);
+    // the second round allocates from the slots and pages the first one returned across threads
+    WorkerBatch batches[16];
+    for (int round = 0; round < 2; round++)
+    {
+        TaskCounter counter;
+        for (int i = 0; i < 16; i++)
+        {
+            batches[i] = { &allocator, (unsigned char)(i + 1), {}, false };
+
+            Task task;
+            task.Type = TaskType::GenericTask;
+            task.Payload.GenericTask = { AllocateAndReturn, &batches[i] };
+            taskManager.ScheduleWork(task, &counter);
+        }
 
-    unsigned char *bufferOne = allocator.GetPointer(offsetOne);
-    for (unsigned char i = 0; i < 16; i++)
+        if (taskManager.Join(&counter).has_value())
+            return false;
+
+        // groups of different threads never overlap
+        for (WorkerBatch& batch : batches)
+        {
+            if (!batch.Valid)
+                return false;
+
+            for (int i = 0; i < GroupsPerBatch / 2; i++)
+            {
+                unsigned char* buffer = static_cast<unsigned char*>(allocator.GetBuffer(batch.Kept[i]));
+                if (buffer == nullptr)
+                    return false;
+
+                for (size_t j = 0; j < BatchGroupSize(i * 2); j++)
+                {
+                    if (buffer[j] != batch.Seed)
+                        return false;
+                }
+                allocator.Return(batch.Kept[i]);
+            }
+        }
+    }
+
+    memoryTracker.EndFrame();
+    return memoryTracker.GetSubsystemUsage(MemorySubsystem::TransientBuffers).LiveBytes == 0;
+}
+
+bool HeapSizeClassTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    HeapAllocator heap(&memoryTracker);
+
+    // 16 byte steps up to 128, four classes per power of two up to the small block limit
+    const size_t requests[] = { 1, 16, 17, 128, 129, 160, 161, 1000, 1024 };
+    const size_t classes[] = { 16, 16, 32, 128, 160, 160, 192, 1024, 1024 };
+    for (size_t i = 0; i < sizeof(requests) / sizeof(requests[0]); i++)
     {
-        bufferOne[i] = i;
+        void* block = heap.Allocate(requests[i]);
+        bool matches = block != nullptr && heap.GetUsableSize(block) == classes[i];
+        heap.Deallocate(block);
+        if (!matches)
+            return false;
     }
 
-    assert(allocator.DebugGetCapacity() == 16);
+    // beyond the limit blocks come from the pool, rounded to 16 bytes
+    void* large = heap.Allocate(HeapAllocator::SmallBlockLimit + 1);
+    bool fits = large != nullptr && heap.GetUsableSize(large) >= HeapAllocator::SmallBlockLimit + 1;
+    heap.Deallocate(large);
+    return fits && heap.GetStats().AllocationCount == 0;
+}
 
-    size_t offsetTwo = allocator.Allocate(5);
-    assert(allocator.DebugGetCapacity() == 32);
+bool HeapCoalesceTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    HeapAllocator heap(&memoryTracker);
+
+    // pool blocks are carved out one after the other, 16 bytes of header each
+    unsigned char* first = static_cast<unsigned char*>(heap.Allocate(2000));
+    unsigned char* second = static_cast<unsigned char*>(heap.Allocate(2000));
+    unsigned char* third = static_cast<unsigned char*>(heap.Allocate(2000));
+    if (second != first + 2016 || third != second + 2016)
+        return false;
+
+    // two neighbours freed make one block that fits what neither could alone
+    heap.Deallocate(first);
+    heap.Deallocate(second);
+    unsigned char* merged = static_cast<unsigned char*>(heap.Allocate(3900));
+    if (merged != first)
+        return false;
+
+    heap.Deallocate(merged);
+    heap.Deallocate(third);
+    HeapStats stats = heap.GetStats();
+    return stats.AllocationCount == 0 && stats.AllocatedBytes == 0 && stats.ReservedBytes == HeapAllocator::PoolSize;
+}
+
+bool HeapReallocTest()
+{
+    using namespace Engine::Core::Runtime;
 
-    unsigned char *bufferTwo = allocator.GetPointer(offsetTwo);
-    for (unsigned char i = 0; i < 5; i++)
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    HeapAllocator heap(&memoryTracker);
+
+    // growing within the size class keeps the block, beyond it the contents move
+    unsigned char* block = static_cast<unsigned char*>(heap.Allocate(20));
+    memset(block, 7, 20);
+    if (heap.Realloc(block, 32) != block)
+        return false;
+
+    unsigned char* moved = static_cast<unsigned char*>(heap.Realloc(block, 4000));
+    if (moved == nullptr || moved == block || heap.GetUsableSize(moved) < 4000)
+        return false;
+    for (int i = 0; i < 20; i++)
     {
-        bufferTwo[i] = i + 16;
+        if (moved[i] != 7)
+            return false;
     }
 
-    unsigned char *bufferOneNew = allocator.GetPointer(offsetOne);
-    for (unsigned char i = 0; i < 16; i++)
+    // the owner goes along with the move
+    void* owned = heap.Allocate(64, 3);
+    void* reowned = heap.Realloc(owned, 2000);
+    memoryTracker.EndFrame();
+    bool owner = memoryTracker.GetUsage(MemorySubsystem::EngineHeap, 3).LiveCount == 1;
+
+    heap.Deallocate(reowned);
+    heap.Deallocate(moved);
+    return owner;
+}
+
+bool HeapHugeBlockTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    HeapAllocator heap(&memoryTracker);
+
+    // huge blocks skip the pools, they only show up as reserved while they're allocated
+    size_t size = HeapAllocator::HugeBlockThreshold + 1;
+    unsigned char* huge = static_cast<unsigned char*>(heap.Allocate(size));
+    if (huge == nullptr)
+        return false;
+    huge[size - 1] = 1;
+
+    HeapStats stats = heap.GetStats();
+    if (stats.AllocationCount != 1 || stats.ReservedBytes < size || stats.AllocatedBytes < size)
+        return false;
+
+    heap.Deallocate(huge);
+    stats = heap.GetStats();
+    return stats.AllocationCount == 0 && stats.ReservedBytes == 0 && stats.AllocatedBytes == 0;
+}
+
+bool HeapRemoteFreeTest()
+{
+    using namespace Engine::Core::Runtime;
+
+    MemoryTracker memoryTracker(&s_Configs, &s_LoggerService);
+    HeapAllocator heap(&memoryTracker);
+
+    // keeps the span current, so the freed block goes back to its free list
+    void* anchor = heap.Allocate(48);
+    void* block = heap.Allocate(48);
+
+    std::thread other([&heap, block]() { heap.Deallocate(block); });
+    other.join();
+
+    // the block waits on the owner's remote list until the end of the frame, then it's the first one handed out again
+    heap.EndFrame();
+    void* reused = heap.Allocate(48);
+    bool drained = reused == block;
+
+    heap.Deallocate(reused);
+    heap.Deallocate(anchor);
+    memoryTracker.EndFrame();
+    return drained && heap.GetStats().AllocationCount == 0 && memoryTracker.GetSubsystemUsage(MemorySubsystem::EngineHeap).LiveBytes == 0;
+}
+
+namespace CompressionTests {
+
+// deterministic noise, nothing in it repeats within a block
+static std::vector<unsigned char> Noise(size_t size)
+{
+    std::vector<unsigned char> data(size);
+    uint32_t state = 0x9E3779B9;
+    for (size_t i = 0; i < size; i++)
     {
-        assert(bufferOneNew[i] == i);
+        state = state * 1664525u + 1013904223u;
+        data[i] = (unsigned char)(state >> 24);
     }
+    return data;
+}
 
-    allocator.Deallocate(offsetOne);
-    assert(allocator.DebugGetOffset() == 0);
+static std::vector<unsigned char> Pattern(size_t size, size_t period)
+{
+    std::vector<unsigned char> data(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (unsigned char)('a' + i % period);
+    }
+    return data;
+}
 
+// compresses into a buffer of the worst case size and back into one of exactly the original size
+static bool RoundTrip(const std::vector<unsigned char>& data, size_t* outCompressedSize = nullptr)
+{
+    using namespace Engine::Utils::Compression;
+
+    std::vector<unsigned char> compressed(BlockCompressBound(data.size()));
+    size_t compressedSize = CompressBlock(data.data(), data.size(), compressed.data(), compressed.size());
+    if (compressedSize == 0)
+        return false;
+    compressed.resize(compressedSize);
+
+    std::vector<unsigned char> decompressed(data.size());
+    if (!DecompressBlock(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) || decompressed != data)
+        return false;
+
+    // a block only decodes into the size it was made from
+    std::vector<unsigned char> shorter(data.size() > 0 ? data.size() - 1 : 0);
+    std::vector<unsigned char> longer(data.size() + 1);
+    if ((data.size() > 0 && DecompressBlock(compressed.data(), compressed.size(), shorter.data(), shorter.size()))
+        || DecompressBlock(compressed.data(), compressed.size(), longer.data(), longer.size()))
+        return false;
+
+    if (outCompressedSize != nullptr)
+        *outCompressedSize = compressedSize;
     return true;
 }
 
-bool MemoryAlignmentTest() {
-    using namespace Engine::Utils::Memory;
+// decodes into an exactly sized heap buffer, so an overrun doesn't go unnoticed under the sanitizers
+static bool Decodes(std::vector<unsigned char> block, size_t destinationSize)
+{
+    std::vector<unsigned char> destination(destinationSize);
+    return Engine::Utils::Compression::DecompressBlock(block.data(), block.size(), destination.data(), destination.size());
+}
 
-    for (size_t i = 1; i < 0xFFFFFFFF; i++) 
+}
+
+bool BlockCodecRoundTripTest()
+{
+    using namespace CompressionTests;
+
+    // noise only grows a little, which the worst case size allows for
+    std::vector<unsigned char> noise = Noise(100000);
+    if (!RoundTrip(noise))
+        return false;
+
+    size_t compressedSize;
+    std::vector<unsigned char> run(100000, 'x');
+    if (!RoundTrip(run, &compressedSize) || compressedSize > run.size() / 100)
+        return false;
+
+    std::vector<unsigned char> pattern = Pattern(100000, 7);
+    if (!RoundTrip(pattern, &compressedSize) || compressedSize > pattern.size() / 100)
+        return false;
+
+    // around the shortest input matches are searched in, shorter ones are all literals
+    for (size_t size = 0; size <= 16; size++)
     {
-        size_t expected = i * 8;
+        if (!RoundTrip(Pattern(size, 2)) || !RoundTrip(Noise(size)))
+            return false;
+    }
 
-        for (size_t j = 1; j < 8; j++) 
+    // a capacity the block doesn't fit into gives up instead of writing past it
+    std::vector<unsigned char> small(noise.size() / 2);
+    return Engine::Utils::Compression::CompressBlock(noise.data(), noise.size(), small.data(), small.size()) == 0;
+}
+
+bool BlockCodecMalformedTest()
+{
+    using namespace CompressionTests;
+
+    // one literal followed by a match of 8 repeating it, then the closing literals
+    if (!Decodes({ 0x14, 'a', 0x01, 0x00, 0x10, 'b' }, 10))
+        return false;
+
+    // truncated: the literal length continues past the end, literals or offset cut short
+    if (Decodes({ 0xF0 }, 20) || Decodes({ 0xF0, 0xFF }, 300) || Decodes({ 0x30, 'a', 'b' }, 3) || Decodes({ 0x14, 'a', 0x01 }, 9))
+        return false;
+
+    // the match length continues past the end
+    if (Decodes({ 0x1F, 'a', 0x01, 0x00 }, 20) || Decodes({ 0x1F, 'a', 0x01, 0x00, 0xFF }, 300))
+        return false;
+
+    // offset 0, and offsets reaching in front of the output
+    if (Decodes({ 0x14, 'a', 0x00, 0x00, 0x10, 'b' }, 10) || Decodes({ 0x14, 'a', 0x02, 0x00, 0x10, 'b' }, 10)
+        || Decodes({ 0x24, 'a', 'b', 0xFF, 0xFF, 0x10, 'c' }, 11))
+        return false;
+
+    // literals or a match running past the end of the output
+    if (Decodes({ 0x40, 'a', 'b', 'c', 'd' }, 3) || Decodes({ 0x1F, 'a', 0x01, 0x00, 0xFF, 0x10 }, 200))
+        return false;
+
+    // well formed, but not the size asked for
+    return !Decodes({ 0x14, 'a', 0x01, 0x00, 0x10, 'b' }, 9) && !Decodes({ 0x14, 'a', 0x01, 0x00, 0x10, 'b' }, 11);
+}
+
+bool DecompressAssetTest()
+{
+    using namespace CompressionTests;
+    using namespace Engine::Core::AssetManagement;
+    using namespace Engine::Core::Runtime;
+
+    ServiceTable services {};
+    services.LoggerService = &s_LoggerService;
+    TaskManager taskManager(&services, &s_LoggerService, 3);
+
+    // noise is stored raw, the pattern compressed, and the last block is a short one
+    std::vector<unsigned char> source = Noise(4096 * 2);
+    std::vector<unsigned char> pattern = Pattern(4096 * 2 + 100, 13);
+    source.insert(source.end(), pattern.begin(), pattern.end());
+
+    std::vector<unsigned char> asset;
+    CompressAsset(source.data(), source.size(), 4096, asset);
+
+    CompressedAssetHeader header;
+    if (!ReadCompressedAssetHeader(asset.data(), asset.size(), &header) || header.BlockCount != 5 || asset.size() >= source.size())
+        return false;
+
+    std::vector<unsigned char> destination(source.size());
+    if (!DecompressAsset(&taskManager, asset.data(), asset.size(), destination.data(), destination.size()) || destination != source)
+        return false;
+
+    // the destination has to be exactly the size in the header
+    std::vector<unsigned char> wrong(source.size() - 1);
+    if (DecompressAsset(&taskManager, asset.data(), asset.size(), wrong.data(), wrong.size()))
+        return false;
+
+    // a header claiming a different size with the same block count makes the last block decode to the wrong size
+    std::vector<unsigned char> resized = asset;
+    uint64_t claimedSize = source.size() - 50;
+    memcpy(resized.data() + offsetof(CompressedAssetHeader, UncompressedSize), &claimedSize, sizeof(claimedSize));
+    std::vector<unsigned char> resizedDestination(claimedSize);
+    if (DecompressAsset(&taskManager, resized.data(), resized.size(), resizedDestination.data(), resizedDestination.size()))
+        return false;
+
+    // blocks cut off at the end, and a block pointing outside the asset
+    if (DecompressAsset(&taskManager, asset.data(), asset.size() - 1, destination.data(), destination.size()))
+        return false;
+
+    std::vector<unsigned char> misplaced = asset;
+    CompressedAssetBlock block { asset.size(), 16 };
+    memcpy(misplaced.data() + sizeof(CompressedAssetHeader) + 2 * sizeof(CompressedAssetBlock), &block, sizeof(block));
+    if (DecompressAsset(&taskManager, misplaced.data(), misplaced.size(), destination.data(), destination.size()))
+        return false;
+
+    // a corrupted compressed block
+    std::vector<unsigned char> corrupted = asset;
+    CompressedAssetBlock compressedBlock;
+    memcpy(&compressedBlock, asset.data() + sizeof(CompressedAssetHeader) + 3 * sizeof(CompressedAssetBlock), sizeof(compressedBlock));
+    corrupted[compressedBlock.Offset + compressedBlock.Size - 1] ^= 0x55;
+    corrupted[compressedBlock.Offset] = 0xFF;
+    return !DecompressAsset(&taskManager, corrupted.data(), corrupted.size(), destination.data(), destination.size());
+}
+
+namespace EventTests {
+
+using namespace Engine::Core::Runtime;
+
+// about 15 to a page
+struct LargeEvent
+{
+    int Index;
+    char Payload[4000];
+};
+
+struct SmallEvent
+{
+    int Index;
+};
+
+// thousands to a page
+struct PackedEvent
+{
+    int Index;
+    float X;
+    float Y;
+};
+
+// every event type starts with its index
+static std::vector<int> ReadIndices(EventStream stream)
+{
+    std::vector<int> indices;
+    while (stream.MoveNext())
+    {
+        int index;
+        memcpy(&index, stream.GetCurrentData(), sizeof(index));
+        indices.push_back(index);
+    }
+    return indices;
+}
+
+static std::vector<int> Sequence(int begin, int end)
+{
+    std::vector<int> sequence;
+    for (int i = begin; i < end; i++)
+    {
+        sequence.push_back(i);
+    }
+    return sequence;
+}
+
+}
+
+bool EventWriterPagingTest()
+{
+    using namespace EventTests;
+
+    EventManager eventManager(&s_LoggerService);
+    EventOwner<LargeEvent> largeOwner = eventManager.RegisterInputEvent<LargeEvent>();
+
+    // events spill into new pages, nothing is moved and the order stays
+    EventWriter writer;
+    static LargeEvent large {};
+    for (int i = 0; i < 100; i++)
+    {
+        large.Index = i;
+        large.Payload[sizeof(large.Payload) - 1] = (char)i;
+        writer.WriteInputEvent(&largeOwner, large, i);
+    }
+
+    EventStream stream = writer.OpenReadStream();
+    for (int i = 0; i < 100; i++)
+    {
+        if (!stream.MoveNext())
+            return false;
+
+        const LargeEvent* current = static_cast<const LargeEvent*>(stream.GetCurrentData());
+        if (current->Index != i || current->Payload[sizeof(large.Payload) - 1] != (char)i || stream.GetCurrentAuthor().Path != i)
+            return false;
+    }
+    if (stream.MoveNext())
+        return false;
+
+    // writers are read back to back, each one in its own write order
+    EventWriter writers[2];
+    for (int i = 0; i < 40; i++)
+    {
+        large.Index = i;
+        writers[i / 20].WriteInputEvent(&largeOwner, large, 0);
+    }
+    return ReadIndices(EventWriter::OpenReadStream(writers, 2)) == Sequence(0, 40);
+}
+
+bool EventWriterRollbackTest()
+{
+    using namespace EventTests;
+
+    EventManager eventManager(&s_LoggerService);
+    EventOwner<LargeEvent> largeOwner = eventManager.RegisterInputEvent<LargeEvent>();
+    EventOwner<SmallEvent> smallOwner = eventManager.RegisterInputEvent<SmallEvent>();
+
+    EventWriter writer;
+    static LargeEvent large {};
+    for (int i = 0; i < 10; i++)
+    {
+        large.Index = i;
+        writer.WriteInputEvent(&largeOwner, large, 0);
+    }
+
+    // undoing writes that went over several pages of more than one owner
+    EventWriterCheckpoint checkpoint = writer.CreateCheckpoint();
+    for (int i = 10; i < 60; i++)
+    {
+        large.Index = i;
+        writer.WriteInputEvent(&largeOwner, large, 0);
+        writer.WriteInputEvent(&smallOwner, SmallEvent { i }, 0);
+    }
+    writer.Rollback(checkpoint);
+    if (ReadIndices(writer.OpenReadStream()) != Sequence(0, 10))
+        return false;
+
+    // writing goes on right where the checkpoint was
+    for (int i = 10; i < 40; i++)
+    {
+        large.Index = i;
+        writer.WriteInputEvent(&largeOwner, large, 0);
+    }
+    if (ReadIndices(writer.OpenReadStream()) != Sequence(0, 40))
+        return false;
+
+    writer.Rollback({ 0 });
+    return !writer.HasEvents() && ReadIndices(writer.OpenReadStream()).empty();
+}
+
+bool EventBucketingTest()
+{
+    using namespace EventTests;
+
+    EventManager eventManager(&s_LoggerService);
+    EventOwner<LargeEvent> largeOwner = eventManager.RegisterInputEvent<LargeEvent>();
+    EventOwner<SmallEvent> smallOwner = eventManager.RegisterInputEvent<SmallEvent>();
+
+    // interleaved writes come back grouped by owner, each owner in its own write order
+    EventWriter writer;
+    static LargeEvent large {};
+    for (int i = 0; i < 50; i++)
+    {
+        large.Index = i;
+        writer.WriteInputEvent(&largeOwner, large, 0);
+        writer.WriteInputEvent(&smallOwner, SmallEvent { 100 + i }, 0);
+    }
+
+    std::vector<int> expected = Sequence(0, 50);
+    std::vector<int> smallIndices = Sequence(100, 150);
+    expected.insert(expected.end(), smallIndices.begin(), smallIndices.end());
+    if (ReadIndices(writer.OpenReadStream()) != expected)
+        return false;
+
+    // an owner nobody registered has no bucket, its events are dropped
+    EventOwner<SmallEvent> unregisteredOwner;
+    EventWriter dropping;
+    dropping.WriteInputEvent(&unregisteredOwner, SmallEvent { 0 }, 0);
+    if (dropping.HasEvents())
+        return false;
+
+    TypedEventStream<SmallEvent> unregistered = writer.OpenReadStream().Filter(&unregisteredOwner);
+    return !unregistered.MoveNext();
+}
+
+bool EventFilterTest()
+{
+    using namespace EventTests;
+
+    EventManager eventManager(&s_LoggerService);
+    EventOwner<SmallEvent> smallOwner = eventManager.RegisterInputEvent<SmallEvent>();
+    EventOwner<LargeEvent> largeOwner = eventManager.RegisterInputEvent<LargeEvent>();
+
+    // the filtered owner spans several pages of every writer, the other owner is skipped in between
+    EventWriter writers[3];
+    static LargeEvent large {};
+    for (int i = 0; i < 90; i++)
+    {
+        large.Index = i;
+        writers[i / 30].WriteInputEvent(&largeOwner, large, i);
+        writers[i / 30].WriteInputEvent(&smallOwner, SmallEvent { -i }, 0);
+    }
+
+    TypedEventStream<LargeEvent> stream = EventWriter::OpenReadStream(writers, 3).Filter(&largeOwner);
+    for (int i = 0; i < 90; i++)
+    {
+        if (!stream.MoveNext())
+            return false;
+
+        if (stream.GetCurrent()->Index != i || stream.GetCurrentAuthor().Path != i || stream.GetCurrentHeader().Length != sizeof(LargeEvent))
+            return false;
+    }
+    if (stream.MoveNext())
+        return false;
+
+    // a writer without events of the owner in the middle doesn't end the stream
+    EventWriter sparse[3];
+    sparse[0].WriteInputEvent(&smallOwner, SmallEvent { 1 }, 0);
+    sparse[1].WriteInputEvent(&largeOwner, large, 0);
+    sparse[2].WriteInputEvent(&smallOwner, SmallEvent { 2 }, 0);
+
+    TypedEventStream<SmallEvent> smallStream = EventWriter::OpenReadStream(sparse, 3).Filter(&smallOwner);
+    std::vector<int> indices;
+    while (smallStream.MoveNext())
+    {
+        indices.push_back(smallStream.GetCurrent()->Index);
+    }
+    return indices == std::vector<int> { 1, 2 };
+}
+
+bool EventPackedBatchTest()
+{
+    using namespace EventTests;
+
+    EventManager eventManager(&s_LoggerService);
+    PackedEventOwner<PackedEvent> packedOwner = eventManager.RegisterPackedEvent<PackedEvent>();
+    EventOwner<SmallEvent> smallOwner = eventManager.RegisterInputEvent<SmallEvent>();
+
+    // packed events of two writers go over several pages, regular events in between don't end up in the batches
+    EventWriter writers[2];
+    for (int i = 0; i < 20000; i++)
+    {
+        writers[i / 10000].WriteInputEvent(&packedOwner, PackedEvent { i, (float)i, -(float)i });
+        if (i % 100 == 0)
+            writers[i / 10000].WriteInputEvent(&smallOwner, SmallEvent { i }, 0);
+    }
+
+    EventBatchStream<PackedEvent> batches = EventWriter::OpenReadStream(writers, 2).Filter(&packedOwner);
+    int next = 0;
+    int batchCount = 0;
+    while (batches.MoveNext())
+    {
+        if (batches.GetCount() == 0)
+            return false;
+
+        const PackedEvent* batch = batches.GetBatch();
+        for (size_t i = 0; i < batches.GetCount(); i++, next++)
         {
-            if (AlignLength((i - 1) * 8 + j, 8) != expected)
+            if (batch[i].Index != next || batch[i].X != (float)next || batch[i].Y != -(float)next)
                 return false;
         }
+        batchCount++;
     }
+    if (next != 20000 || batchCount < 4)
+        return false;
 
-    return true;
+    // a regular stream goes through packed events one by one, without an author
+    EventStream stream = writers[0].OpenReadStream();
+    for (int i = 0; i < 10000; i++)
+    {
+        if (!stream.MoveNext())
+            return false;
+
+        EventHeader header = stream.GetCurrentHeader();
+        if (header.Author != UnknownEventAuthor || header.Length != sizeof(PackedEvent) || stream.GetCurrentAuthor().Name != nullptr)
+            return false;
+        if (static_cast<const PackedEvent*>(stream.GetCurrentData())->Index != i)
+            return false;
+    }
+
+    std::vector<int> smallIndices;
+    while (stream.MoveNext())
+    {
+        if (stream.GetCurrentHeader().Length != sizeof(SmallEvent))
+            return false;
+
+        smallIndices.push_back(static_cast<const SmallEvent*>(stream.GetCurrentData())->Index);
+    }
+    if (smallIndices.size() != 100 || smallIndices.front() != 0 || smallIndices.back() != 9900)
+        return false;
+
+    // rolling back packed events takes them off the last pages
+    EventWriter writer;
+    for (int i = 0; i < 1000; i++)
+    {
+        writer.WriteInputEvent(&packedOwner, PackedEvent { i, 0.0f, 0.0f });
+    }
+
+    EventWriterCheckpoint checkpoint = writer.CreateCheckpoint();
+    for (int i = 1000; i < 15000; i++)
+    {
+        writer.WriteInputEvent(&packedOwner, PackedEvent { -1, 0.0f, 0.0f });
+    }
+    writer.Rollback(checkpoint);
+    writer.WriteInputEvent(&packedOwner, PackedEvent { 1000, 0.0f, 0.0f });
+
+    return ReadIndices(writer.OpenReadStream()) == Sequence(0, 1001);
 }
 
 int main()
 {
-    // SE_TEST_RUNTEST(BpTreeTest);
-    // SE_TEST_RUNTEST(CacheLineAllocatorTest);
-    // SE_TEST_RUNTEST(BucketAllocatorTest);
-
-    // SE_TEST_RUNTEST(StackAllocatorTest);
-
-    SE_TEST_RUNTEST(MemoryAlignmentTest);
+    SE_TEST_RUNTEST(TaskGraphDiamondTest);
+    SE_TEST_RUNTEST(TaskGraphCycleTest);
+    SE_TEST_RUNTEST(TaskGraphFailureTest);
+    SE_TEST_RUNTEST(TransientGroupReuseTest);
+    SE_TEST_RUNTEST(TransientGroupChildrenTest);
+    SE_TEST_RUNTEST(TransientLargeGroupTest);
+    SE_TEST_RUNTEST(TransientMultiWorkerTest);
+    SE_TEST_RUNTEST(HeapSizeClassTest);
+    SE_TEST_RUNTEST(HeapCoalesceTest);
+    SE_TEST_RUNTEST(HeapReallocTest);
+    SE_TEST_RUNTEST(HeapHugeBlockTest);
+    SE_TEST_RUNTEST(HeapRemoteFreeTest);
+    SE_TEST_RUNTEST(BlockCodecRoundTripTest);
+    SE_TEST_RUNTEST(BlockCodecMalformedTest);
+    SE_TEST_RUNTEST(DecompressAssetTest);
+    SE_TEST_RUNTEST(EventWriterPagingTest);
+    SE_TEST_RUNTEST(EventWriterRollbackTest);
+    SE_TEST_RUNTEST(EventBucketingTest);
+    SE_TEST_RUNTEST(EventFilterTest);
+    SE_TEST_RUNTEST(EventPackedBatchTest);
 
     std::cout << "DONE" << std::endl;
     return 0;
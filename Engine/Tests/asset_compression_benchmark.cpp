@@ -0,0 +1,195 @@
+#include "EngineCore/AssetManagement/compressed_asset.h"
+#include "EngineCore/Configuration/configuration_provider.h"
+#include "EngineCore/Logging/logger_service.h"
+#include "EngineCore/Runtime/service_table.h"
+#include "EngineCore/Runtime/task_manager.h"
+
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_timer.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// loads the same asset raw and compressed through files on disk, and decompresses it with one worker up to N workers;
+// pass asset files to measure real content, otherwise a generated mesh and a generated shader are used:
+//     AssetCompressionBenchmark [workers] [asset file]...
+// repeated runs read from the page cache, so the raw numbers are an upper bound of what a disk delivers; on an IO bound
+// load the compressed path wins as long as decompression is faster than the disk
+
+using namespace Engine::Core;
+
+static constexpr int Repetitions = 5;
+
+struct Sample
+{
+    std::string Name;
+    std::vector<unsigned char> Data;
+};
+
+// interleaved position, normal and uv of a displaced grid, the same layout the static mesh loader reads
+static std::vector<unsigned char> GenerateMesh(size_t gridSize)
+{
+    std::vector<float> vertices;
+    vertices.reserve(gridSize * gridSize * 8);
+    for (size_t y = 0; y < gridSize; y++)
+    {
+        for (size_t x = 0; x < gridSize; x++)
+        {
+            float u = (float)x / gridSize;
+            float v = (float)y / gridSize;
+            float height = std::sin(u * 12.0f) * std::cos(v * 9.0f) * 0.25f;
+            float values[] = { u * 10.0f, height, v * 10.0f, 0.0f, 1.0f, 0.0f, u, v };
+            vertices.insert(vertices.end(), std::begin(values), std::end(values));
+        }
+    }
+
+    std::vector<unsigned char> bytes(vertices.size() * sizeof(float));
+    memcpy(bytes.data(), vertices.data(), bytes.size());
+    return bytes;
+}
+
+// SPIR-V is a stream of small words with a handful of opcodes and ids that mostly count up
+static std::vector<unsigned char> GenerateShader(size_t instructionCount)
+{
+    std::vector<uint32_t> words { 0x07230203, 0x00010000, 0x0008000B, 0x00000100, 0 };
+    unsigned long long seed = 1;
+    for (size_t i = 0; i < instructionCount; i++)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        uint32_t opcodes[] = { 61, 62, 65, 79, 129, 133, 142 };
+        uint32_t operandCount = 2 + (uint32_t)(seed >> 61);
+        words.push_back(((operandCount + 1) << 16) | opcodes[(seed >> 33) % 7]);
+        for (uint32_t j = 0; j < operandCount; j++)
+        {
+            words.push_back((uint32_t)(i + j) % 4096 + 1);
+        }
+    }
+
+    std::vector<unsigned char> bytes(words.size() * sizeof(uint32_t));
+    memcpy(bytes.data(), words.data(), bytes.size());
+    return bytes;
+}
+
+static bool ReadAll(const char* path, std::vector<unsigned char>& output)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    output.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool WriteAll(const char* path, const std::vector<unsigned char>& data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char*)data.data(), data.size());
+    return (bool)file;
+}
+
+template <typename Routine>
+static double BestOf(Routine routine)
+{
+    double best = 0;
+    for (int i = 0; i < Repetitions; i++)
+    {
+        Uint64 begin = SDL_GetTicksNS();
+        routine();
+        double elapsed = (double)(SDL_GetTicksNS() - begin) / 1000000.0;
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+static double Throughput(size_t bytes, double milliseconds)
+{
+    return (double)bytes / (1024.0 * 1024.0) / (milliseconds / 1000.0);
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxWorkers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t)SDL_GetNumLogicalCPUCores();
+    if (maxWorkers == 0)
+        maxWorkers = 1;
+
+    std::vector<Sample> samples;
+    for (int i = 2; i < argc; i++)
+    {
+        Sample sample { argv[i] };
+        if (!ReadAll(argv[i], sample.Data))
+        {
+            std::cout << "can't read " << argv[i] << std::endl;
+            return 1;
+        }
+        samples.push_back(std::move(sample));
+    }
+
+    if (samples.empty())
+    {
+        samples.push_back({ "generated mesh", GenerateMesh(1024) });
+        samples.push_back({ "generated shader", GenerateShader(1 << 20) });
+    }
+
+    Configuration::ConfigurationProvider configs;
+    Logging::LoggerService loggerService(configs);
+
+    Runtime::ServiceTable services {};
+    services.LoggerService = &loggerService;
+
+    const char* rawPath = "asset_compression_benchmark.raw";
+    const char* compressedPath = "asset_compression_benchmark.compressed";
+
+    for (const Sample& sample : samples)
+    {
+        std::vector<unsigned char> compressed;
+        double compressTime = BestOf([&]() { AssetManagement::CompressAsset(sample.Data.data(), sample.Data.size(), AssetManagement::CompressedAssetBlockSize, compressed); });
+
+        if (!WriteAll(rawPath, sample.Data) || !WriteAll(compressedPath, compressed))
+        {
+            std::cout << "can't write the benchmark files to the working directory" << std::endl;
+            return 1;
+        }
+
+        std::cout << sample.Name << ": " << sample.Data.size() << " -> " << compressed.size() << " bytes, ratio "
+            << (double)sample.Data.size() / compressed.size() << "x, compression " << Throughput(sample.Data.size(), compressTime) << " MiB/s" << std::endl;
+
+        std::vector<unsigned char> readBuffer;
+        double rawTime = BestOf([&]() { ReadAll(rawPath, readBuffer); });
+        std::cout << "  raw load: " << rawTime << " ms, " << Throughput(sample.Data.size(), rawTime) << " MiB/s" << std::endl;
+
+        std::vector<unsigned char> destination(sample.Data.size());
+        for (size_t workers = 1; workers <= maxWorkers; workers++)
+        {
+            Runtime::TaskManager taskManager(&services, &loggerService, workers);
+
+            bool valid = true;
+            double decompressTime = BestOf([&]() {
+                valid &= AssetManagement::DecompressAsset(&taskManager, compressed.data(), compressed.size(), destination.data(), destination.size());
+            });
+            double loadTime = BestOf([&]() {
+                ReadAll(compressedPath, readBuffer);
+                valid &= AssetManagement::DecompressAsset(&taskManager, readBuffer.data(), readBuffer.size(), destination.data(), destination.size());
+            });
+
+            if (!valid || destination != sample.Data)
+            {
+                std::cout << "decompressed data doesn't match the source" << std::endl;
+                return 1;
+            }
+
+            // throughput is measured in decompressed bytes so it compares directly to the raw load
+            std::cout << "  " << workers << " worker(s): decompression " << Throughput(sample.Data.size(), decompressTime) << " MiB/s, compressed load "
+                << loadTime << " ms, " << Throughput(sample.Data.size(), loadTime) << " MiB/s, speedup " << rawTime / loadTime << "x" << std::endl;
+        }
+    }
+
+    std::remove(rawPath);
+    std::remove(compressedPath);
+    return 0;
+}
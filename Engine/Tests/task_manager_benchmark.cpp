@@ -0,0 +1,122 @@
+#include "EngineCore/Configuration/configuration_provider.h"
+#include "EngineCore/Logging/logger_service.h"
+#include "EngineCore/Runtime/crash_dump.h"
+#include "EngineCore/Runtime/service_table.h"
+#include "EngineCore/Runtime/task_manager.h"
+
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_timer.h>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+// throughput of the task manager from one worker up to N workers; every root task fans out children through the
+// scheduler interface the same way event callbacks do, so stealing and counter joins are both on the measured path
+
+using namespace Engine::Core;
+
+static constexpr size_t RootTaskCount = 4096;
+static constexpr size_t ChildrenPerRoot = 15;
+static constexpr size_t IterationsPerTask = 5000;
+static constexpr int Repetitions = 5;
+
+struct BenchmarkState
+{
+    Runtime::ITaskScheduler* Scheduler;
+    std::atomic<unsigned long long> Checksum;
+};
+
+static BenchmarkState s_State;
+
+static unsigned long long Spin(unsigned long long seed)
+{
+    // a cheap lcg that the optimizer cannot fold away
+    for (size_t i = 0; i < IterationsPerTask; i++)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return seed;
+}
+
+static Runtime::CallbackResult ChildTask(void* state)
+{
+    s_State.Checksum.fetch_add(Spin((size_t)state) & 0xFF, std::memory_order_relaxed);
+    return Runtime::CallbackSuccess();
+}
+
+static Runtime::CallbackResult RootTask(void* state)
+{
+    for (size_t i = 0; i < ChildrenPerRoot; i++)
+    {
+        s_State.Scheduler->ScheduleTask(ChildTask, (void*)((size_t)state * ChildrenPerRoot + i));
+    }
+
+    s_State.Checksum.fetch_add(Spin((size_t)state) & 0xFF, std::memory_order_relaxed);
+    return Runtime::CallbackSuccess();
+}
+
+static double RunOnce(Runtime::TaskManager* taskManager)
+{
+    s_State.Scheduler = taskManager;
+    s_State.Checksum.store(0);
+
+    Runtime::TaskCounter counter;
+    Uint64 begin = SDL_GetTicksNS();
+
+    for (size_t i = 0; i < RootTaskCount; i++)
+    {
+        Runtime::Task task;
+        task.Type = Runtime::TaskType::GenericTask;
+        task.Payload.GenericTask = { RootTask, (void*)i };
+        taskManager->ScheduleWork(task, &counter);
+    }
+
+    Runtime::CallbackResult result = taskManager->Join(&counter);
+    Uint64 end = SDL_GetTicksNS();
+
+    if (result.has_value())
+    {
+        std::cout << "task failed: " << result->ErrorDetail << std::endl;
+        std::exit(1);
+    }
+
+    return (double)(end - begin) / 1000000.0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxWorkers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t)SDL_GetNumLogicalCPUCores();
+    if (maxWorkers == 0)
+        maxWorkers = 1;
+
+    Configuration::ConfigurationProvider configs;
+    Logging::LoggerService loggerService(configs);
+
+    Runtime::ServiceTable services {};
+    services.LoggerService = &loggerService;
+
+    const double totalTasks = (double)(RootTaskCount * (ChildrenPerRoot + 1));
+    double baseline = 0;
+
+    std::cout << "tasks per run: " << (size_t)totalTasks << ", best of " << Repetitions << " runs, main thread helps in every run" << std::endl;
+
+    for (size_t workers = 1; workers <= maxWorkers; workers++)
+    {
+        Runtime::TaskManager taskManager(&services, &loggerService, workers);
+
+        double best = RunOnce(&taskManager);
+        for (int i = 1; i < Repetitions; i++)
+        {
+            double elapsed = RunOnce(&taskManager);
+            if (elapsed < best)
+                best = elapsed;
+        }
+
+        if (workers == 1)
+            baseline = best;
+
+        std::cout << workers << " worker(s): " << best << " ms, " << (size_t)(totalTasks / best * 1000.0) << " tasks/s, speedup " << baseline / best << "x" << std::endl;
+    }
+
+    return 0;
+}
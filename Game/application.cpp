@@ -1,3 +1,4 @@
+#include "EngineCore/Configuration/configuration_provider.h"
 #include "EngineCore/Pipeline/hash_id.h"
 #include "EngineCore/Pipeline/module_assembly.h"
 #include "EngineCore/Runtime/event_manager.h"
@@ -13,6 +14,8 @@
 #include "glm/ext/vector_float3.hpp"
 
 #include <md5.h>
+#include <cstdlib>
+#include <cstring>
 
 static Engine::Core::Pipeline::HashId ExampleModuleName = Engine::Extension::ExampleGameplayModule::GetDefinition().Name.Hash;
 static Engine::Core::Pipeline::HashId InputModuleName = Engine::Extension::InputModule::GetModuleDefinition().Name.Hash;
@@ -50,16 +53,25 @@ void FoobarEventSystem(const Engine::Core::Runtime::ServiceTable* services, void
 
         if (inputLevel > 0)
         {
-            writer->WriteInputEvent(&rootModule->TransformUpdateEventOwner, Engine::Core::Runtime::TransformUpdateEventData { newTransform, marker.Entity }, 0);
+            writer->WriteInputEvent(&rootModule->TransformUpdateEventOwner, Engine::Core::Runtime::TransformUpdateEventData { newTransform, marker.Entity });
         }
     }
 
     return;
 }
 
-int main()
+int main(int argc, char** argv)
 {
-    Engine::Core::Runtime::GameLoop gameloop(Engine::Core::Pipeline::ListModules(), {});
+    // --headless [frames] runs without a window or GPU, e.g. to profile the simulation on build machines
+    Engine::Core::Configuration::ConfigurationProvider configs;
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0)
+    {
+        configs.Headless = true;
+        if (argc > 2)
+            configs.FrameLimit = strtoul(argv[2], nullptr, 10);
+    }
+
+    Engine::Core::Runtime::GameLoop gameloop(Engine::Core::Pipeline::ListModules(), configs);
     gameloop.AddEventSystem(&FoobarEventSystem, "FoobarEventSystem");
     Engine::Core::Runtime::CallbackResult gameError = gameloop.Run(md5::compute("Entities/example.se_entity"));
 
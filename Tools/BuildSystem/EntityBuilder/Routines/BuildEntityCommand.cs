@@ -247,6 +247,11 @@ public class BuildEntityCommand : Command
         ImmutableDictionary<string, BuildResult> buildOutput = await coordinator.OutputTask.ConfigureAwait(false);
         _logger.Information("Assets built.");
 
+        // the engine takes asset sizes from the entity file instead of querying the file system for each of them
+        ImmutableDictionary<string, long> assetSizes = buildOutput
+            .Where(output => output.Value.Errors.Length == 0)
+            .ToImmutableDictionary(output => output.Key, output => new FileInfo(output.Value.OutputPath).Length);
+
         // copy the built assets to the output folder
         Task copyTask = Task.Run(() =>
         {
@@ -372,7 +377,8 @@ public class BuildEntityCommand : Command
         _logger.Verbose("Writing out asset groups ...");
         string entityFilePath = Path.Combine(outPath.FullName, Path.ChangeExtension(Convert.ToHexString(MD5.HashData(Encoding.UTF8.GetBytes(Path.GetRelativePath(Environment.CurrentDirectory, inputFile.FullName)))), "bse_entity"));
         await using FileStream outEntityFile = File.Create(entityFilePath);
-        outEntityFile.Write(0xCCBBFFF1);
+        // asset section format with sizes and compressed sizes, see EngineCore/AssetManagement/entity_file.h
+        outEntityFile.Write(0xCCBBFFF5);
         outEntityFile.Write(groupOrdering.Count);
         foreach (AssetGroup group in groupOrdering)
         {
@@ -382,6 +388,10 @@ public class BuildEntityCommand : Command
             foreach (string task in group.Tasks)
             {
                 outEntityFile.Write(MD5.HashData(Encoding.UTF8.GetBytes(task)));
+                outEntityFile.Write<long>(assetSizes.GetValueOrDefault(task, 0));
+
+                // built assets are raw, AssetPacker --compress fills this in
+                outEntityFile.Write<long>(0);
             }
             _logger.Information("Printed asset group {module}:{type}", group.Module, group.Type);
         }